@@ -0,0 +1,139 @@
+#include "AStarSearch.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+AStarSearch::AStarSearch(Maze* maze) {
+   this->maze = maze;
+   costs = new int[maze->size()];
+   stamps = new int[maze->size()]();
+   currentStamp = 0;
+   parents = new DirectionGrid(maze->size());
+   landmarks = NULL;
+   nodesExpanded = 0;
+}
+
+AStarSearch::~AStarSearch() {
+   delete[] costs;
+   costs = nullptr;
+   delete[] stamps;
+   stamps = nullptr;
+   delete parents;
+   parents = nullptr;
+}
+
+int AStarSearch::getNodesExpanded() {
+   return nodesExpanded;
+}
+
+void AStarSearch::setLandmarks(LandmarkIndex* landmarks) {
+   this->landmarks = landmarks;
+}
+
+void AStarSearch::nextStamp() {
+
+   // When the stamp runs out, clear the stamps and start counting again
+   if(currentStamp == INT_MAX) {
+      for(int i = 0; i < maze->size(); ++i) {
+         stamps[i] = 0;
+      }
+      currentStamp = 0;
+   }
+   currentStamp++;
+}
+
+bool AStarSearch::openAfter(const OpenNode& a, const OpenNode& b) {
+   return a.estimate > b.estimate || (a.estimate == b.estimate && a.cost < b.cost);
+}
+
+bool AStarSearch::findPath(int fromX, int fromY, int toX, int toY, PDList* path) {
+
+   nextStamp();
+   open.clear();
+   nodesExpanded = 0;
+
+   // A goal outside the maze can never be reached
+   if(toX < 0 || toX >= maze->getCols() || toY < 0 || toY >= maze->getRows()) {
+      return false;
+   }
+
+   int startIndex = maze->index(fromX, fromY);
+   int goalIndex = maze->index(toX, toY);
+
+   // The landmarks can tell straight away that the goal cannot be reached
+   // The start is not always open, the landmarks only know about open cells
+   if(landmarks != NULL && maze->isOpen(startIndex) &&
+      landmarks->lowerBound(fromX, fromY, toX, toY) == LANDMARK_UNREACHABLE) {
+      return false;
+   }
+
+   // {Left, Right, Up, Down}, the same order as Maze::getMove
+   int moveHorizontal[LRUD] = {-1, 1, 0, 0};
+   int moveVertical[LRUD] = {0, 0, -1, 1};
+
+   costs[startIndex] = 0;
+   stamps[startIndex] = currentStamp;
+   open.push_back({std::abs(toX - fromX) + std::abs(toY - fromY), 0, startIndex});
+
+   bool found = false;
+   while(!open.empty() && !found) {
+      std::pop_heap(open.begin(), open.end(), openAfter);
+      OpenNode node = open.back();
+      open.pop_back();
+
+      // A shorter way to this cell was found after this entry was added, skip it
+      if(node.cost == costs[node.index]) {
+         nodesExpanded++;
+
+         if(node.index == goalIndex) {
+            found = true;
+         }
+         else {
+            int x = maze->getX(node.index);
+            int y = maze->getY(node.index);
+
+            for(int i = 0; i < LRUD; ++i) {
+               int next = node.index + maze->getMove(i);
+               int cost = node.cost + 1;
+
+               if(maze->isOpen(next) &&
+                  (stamps[next] != currentStamp || cost < costs[next])) {
+
+                  int nextX = x + moveHorizontal[i];
+                  int nextY = y + moveVertical[i];
+                  int bound = landmarks != NULL ? landmarks->lowerBound(nextX, nextY, toX, toY) : 0;
+
+                  // A cell the landmarks show cannot reach the goal is left out
+                  if(bound != LANDMARK_UNREACHABLE) {
+                     int heuristic = std::max(std::abs(toX - nextX) + std::abs(toY - nextY), bound);
+
+                     stamps[next] = currentStamp;
+                     costs[next] = cost;
+                     parents->set(next, i);
+
+                     open.push_back({cost + heuristic, cost, next});
+                     std::push_heap(open.begin(), open.end(), openAfter);
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   // Undo the stored moves from the goal back to the start
+   if(found) {
+      int index = goalIndex;
+      int distance = costs[goalIndex];
+      path->addBack(toX, toY, distance);
+
+      while(index != startIndex) {
+         index -= maze->getMove(parents->get(index));
+         distance--;
+
+         path->addBack(maze->getX(index), maze->getY(index), distance);
+      }
+   }
+
+   return found;
+}
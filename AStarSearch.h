@@ -0,0 +1,92 @@
+#ifndef COSC_ASS_ONE_ASTAR_SEARCH
+#define COSC_ASS_ONE_ASTAR_SEARCH
+
+#include "DirectionGrid.h"
+#include "LandmarkIndex.h"
+#include "Maze.h"
+#include "PDList.h"
+
+#include <vector>
+
+// Point-to-point A* search on a Maze.
+//    Uses the Manhattan distance to the goal as the heuristic. It never
+//    over-estimates with the four LRUD moves, so the path found is a shortest path.
+//    The search stops as soon as the goal is taken off the open list, so only
+//    the part of the maze between the start and the goal is looked at.
+//    With a LandmarkIndex, the heuristic is the bigger of the Manhattan distance and
+//    the landmarks' lower bound, which is still never too big but is far closer in a
+//    maze with walls, and cells that the landmarks show cannot reach the goal are never added.
+//    The scratch arrays are kept between searches and are not cleared, a cell
+//    only counts as seen if its stamp matches the current search.
+class AStarSearch {
+public:
+
+   // Create a search for the given maze, the maze is not owned by the search
+   AStarSearch(Maze* maze);
+
+   // Clean-up
+   ~AStarSearch();
+
+   // Find a shortest path from (fromX,fromY) to (toX,toY)
+   //    The path is added to the given list from the goal back to the start,
+   //    each position with its distance from the start, the same as PathPlanning::getPath.
+   //    Returns false and adds nothing if the goal cannot be reached.
+   bool findPath(int fromX, int fromY, int toX, int toY, PDList* path);
+
+   // Number of cells taken off the open list by the last search
+   int getNodesExpanded();
+
+   // Use the given landmarks for the heuristic, or only the Manhattan distance for NULL
+   //    The landmarks are not owned by the search, and must be for the same maze
+   void setLandmarks(LandmarkIndex* landmarks);
+
+   AStarSearch(AStarSearch& other) = delete;
+   AStarSearch& operator=(AStarSearch& other) = delete;
+
+private:
+
+   // An entry in the open list
+   struct OpenNode {
+      // Estimated length of a path through this cell (cost + heuristic)
+      int estimate;
+
+      // Distance from the start when the entry was added
+      int cost;
+
+      // Maze index of the cell
+      int index;
+   };
+
+   // The maze being searched
+   Maze* maze;
+
+   // Best known distance from the start for every cell
+   int* costs;
+
+   // The search a cell was last seen in, costs and parents are only valid if this matches currentStamp
+   int* stamps;
+
+   // Stamp of the current search
+   int currentStamp;
+
+   // The move that reached every cell
+   DirectionGrid* parents;
+
+   // The landmarks for the heuristic, or NULL
+   LandmarkIndex* landmarks;
+
+   // The open list, a binary heap ordered by estimate
+   std::vector<OpenNode> open;
+
+   // Number of cells taken off the open list by the last search
+   int nodesExpanded;
+
+   // Start a new search, making every cell unseen
+   void nextStamp();
+
+   // Order of the heap, the entry with the smallest estimate comes first
+   //    Equal estimates prefer the entry furthest from the start, it is closer to the goal
+   static bool openAfter(const OpenNode& a, const OpenNode& b);
+};
+
+#endif // COSC_ASS_ONE_ASTAR_SEARCH
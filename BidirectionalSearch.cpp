@@ -0,0 +1,148 @@
+#include "BidirectionalSearch.h"
+
+#include <algorithm>
+#include <climits>
+
+BidirectionalSearch::BidirectionalSearch(Maze* maze) {
+   this->maze = maze;
+
+   forward.distances = new int[maze->size()];
+   forward.stamps = new int[maze->size()]();
+   forward.parents = new DirectionGrid(maze->size());
+
+   backward.distances = new int[maze->size()];
+   backward.stamps = new int[maze->size()]();
+   backward.parents = new DirectionGrid(maze->size());
+
+   currentStamp = 0;
+   nodesExpanded = 0;
+}
+
+BidirectionalSearch::~BidirectionalSearch() {
+   delete[] forward.distances;
+   delete[] forward.stamps;
+   delete forward.parents;
+
+   delete[] backward.distances;
+   delete[] backward.stamps;
+   delete backward.parents;
+}
+
+int BidirectionalSearch::getNodesExpanded() {
+   return nodesExpanded;
+}
+
+void BidirectionalSearch::nextStamp() {
+
+   // When the stamp runs out, clear the stamps and start counting again
+   if(currentStamp == INT_MAX) {
+      for(int i = 0; i < maze->size(); ++i) {
+         forward.stamps[i] = 0;
+         backward.stamps[i] = 0;
+      }
+      currentStamp = 0;
+   }
+   currentStamp++;
+}
+
+void BidirectionalSearch::expandLevel(Side& side, Side& other, int& best,
+                                      int& thisIndex, int& otherIndex) {
+   side.next.clear();
+
+   for(int index : side.frontier) {
+      nodesExpanded++;
+
+      for(int i = 0; i < LRUD; ++i) {
+         int next = index + maze->getMove(i);
+
+         // Cells seen by the other end are already known to be open (or to be its end)
+         if(other.stamps[next] == currentStamp) {
+            int length = side.distances[index] + 1 + other.distances[next];
+            if(length < best) {
+               best = length;
+               thisIndex = index;
+               otherIndex = next;
+            }
+         }
+         else if(side.stamps[next] != currentStamp && maze->isOpen(next)) {
+            side.stamps[next] = currentStamp;
+            side.distances[next] = side.distances[index] + 1;
+            side.parents->set(next, i);
+            side.next.push_back(next);
+         }
+      }
+   }
+
+   side.frontier.swap(side.next);
+}
+
+void BidirectionalSearch::traceSide(Side& side, int index, std::vector<int>& cells) {
+   cells.push_back(index);
+   while(side.distances[index] != 0) {
+      index -= maze->getMove(side.parents->get(index));
+      cells.push_back(index);
+   }
+}
+
+bool BidirectionalSearch::findPath(int fromX, int fromY, int toX, int toY, PDList* path) {
+
+   nextStamp();
+   nodesExpanded = 0;
+
+   // A goal outside the maze can never be reached
+   if(toX < 0 || toX >= maze->getCols() || toY < 0 || toY >= maze->getRows()) {
+      return false;
+   }
+
+   int startIndex = maze->index(fromX, fromY);
+   int goalIndex = maze->index(toX, toY);
+
+   // The path goes from the goal back to the start
+   std::vector<int> cells;
+
+   if(startIndex == goalIndex) {
+      cells.push_back(startIndex);
+   }
+   else if(maze->isOpen(goalIndex)) {
+      forward.frontier.clear();
+      forward.frontier.push_back(startIndex);
+      forward.stamps[startIndex] = currentStamp;
+      forward.distances[startIndex] = 0;
+
+      backward.frontier.clear();
+      backward.frontier.push_back(goalIndex);
+      backward.stamps[goalIndex] = currentStamp;
+      backward.distances[goalIndex] = 0;
+
+      int best = INT_MAX;
+      int forwardIndex = 0;
+      int backwardIndex = 0;
+
+      // Grow the smaller frontier until the two ends meet or one end runs out of cells
+      while(best == INT_MAX && !forward.frontier.empty() && !backward.frontier.empty()) {
+         if(forward.frontier.size() <= backward.frontier.size()) {
+            expandLevel(forward, backward, best, forwardIndex, backwardIndex);
+         }
+         else {
+            expandLevel(backward, forward, best, backwardIndex, forwardIndex);
+         }
+      }
+
+      if(best != INT_MAX) {
+
+         // Goal to the meeting point, then the meeting point to the start
+         traceSide(backward, backwardIndex, cells);
+         std::reverse(cells.begin(), cells.end());
+         traceSide(forward, forwardIndex, cells);
+      }
+   }
+
+   // Add the cells to the path, the goal is the furthest from the start
+   int distance = (int) cells.size() - 1;
+   for(int index : cells) {
+      path->addBack(maze->getX(index), maze->getY(index), distance);
+      distance--;
+   }
+
+   return !cells.empty();
+}
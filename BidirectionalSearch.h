@@ -0,0 +1,82 @@
+#ifndef COSC_ASS_ONE_BIDIRECTIONAL_SEARCH
+#define COSC_ASS_ONE_BIDIRECTIONAL_SEARCH
+
+#include "DirectionGrid.h"
+#include "Maze.h"
+#include "PDList.h"
+
+#include <vector>
+
+// Point-to-point breadth-first search from both ends on a Maze.
+//    One frontier grows from the start and one from the goal, one whole level
+//    at a time, always growing the smaller frontier. The search stops at the
+//    end of the first level where the two meet, taking the shortest of the
+//    meetings found in that level, so the path found is a shortest path.
+//    Like AStarSearch, the scratch arrays are kept between searches and a cell
+//    only counts as seen if its stamp matches the current search.
+class BidirectionalSearch {
+public:
+
+   // Create a search for the given maze, the maze is not owned by the search
+   BidirectionalSearch(Maze* maze);
+
+   // Clean-up
+   ~BidirectionalSearch();
+
+   // Find a shortest path from (fromX,fromY) to (toX,toY)
+   //    The path is added to the given list from the goal back to the start,
+   //    each position with its distance from the start, the same as PathPlanning::getPath.
+   //    Returns false and adds nothing if the goal cannot be reached.
+   bool findPath(int fromX, int fromY, int toX, int toY, PDList* path);
+
+   // Number of cells expanded (from both ends) by the last search
+   int getNodesExpanded();
+
+   BidirectionalSearch(BidirectionalSearch& other) = delete;
+   BidirectionalSearch& operator=(BidirectionalSearch& other) = delete;
+
+private:
+
+   // The search state of one end
+   struct Side {
+      // Distance from this end for every cell
+      int* distances;
+
+      // The search a cell was last seen in from this end
+      int* stamps;
+
+      // The move that reached every cell from this end
+      DirectionGrid* parents;
+
+      // The cells of the level being expanded, and of the next level
+      std::vector<int> frontier;
+      std::vector<int> next;
+   };
+
+   // The maze being searched
+   Maze* maze;
+
+   // The end growing from the start, and the end growing from the goal
+   Side forward;
+   Side backward;
+
+   // Stamp of the current search
+   int currentStamp;
+
+   // Number of cells expanded by the last search
+   int nodesExpanded;
+
+   // Start a new search, making every cell unseen from both ends
+   void nextStamp();
+
+   // Expand one whole level of the given side
+   //    If the level touches a cell seen by the other side, the shortest such
+   //    meeting is stored in best, thisIndex and otherIndex
+   void expandLevel(Side& side, Side& other, int& best, int& thisIndex, int& otherIndex);
+
+   // Add the cells from index back to the end the side started from, following its moves
+   //    Each index is added to the back of cells
+   void traceSide(Side& side, int index, std::vector<int>& cells);
+};
+
+#endif // COSC_ASS_ONE_BIDIRECTIONAL_SEARCH
@@ -0,0 +1,251 @@
+#include "BinaryMazeFile.h"
+
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// Number of numbers in one stored position
+#define POSITION_INTS 2
+
+BinaryMazeFile::BinaryMazeFile(std::string filename) {
+   region = nullptr;
+   regionBytes = 0;
+   maze = nullptr;
+
+   int fd = open(filename.c_str(), O_RDONLY);
+   if(fd < 0) {
+      throw std::runtime_error("Could not open file '" + filename + "'");
+   }
+
+   struct stat info;
+   if(fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(Header)) {
+      close(fd);
+      throw std::runtime_error("Not a binary maze file '" + filename + "'");
+   }
+   regionBytes = info.st_size;
+
+   // Writes only go to a private copy of the page, so the file is never changed
+   void* mapped = mmap(nullptr, regionBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if(mapped == MAP_FAILED) {
+      throw std::runtime_error("Could not map file '" + filename + "'");
+   }
+   region = (char*) mapped;
+   header = (Header*) region;
+
+   // Only the header is read, every section must fit in the file where it says it is
+   bool valid = std::memcmp(header->magic, BINARY_MAZE_MAGIC, sizeof(header->magic)) == 0 &&
+                header->version == BINARY_MAZE_VERSION &&
+                header->rows > 0 && header->cols > 0 &&
+                header->numStarts >= 0 && header->numGoals >= 0 &&
+                header->fileBytes == regionBytes;
+   if(valid) {
+      // The sizes are worked out in 64 bits, the maze's indexes must still fit in an int
+      uint64_t cells = (uint64_t) header->rows * header->cols;
+      uint64_t borderedCells = ((uint64_t) header->rows + 2) * ((uint64_t) header->cols + 2);
+      uint64_t bitsBytes = (borderedCells / MAZE_WORD_BITS + 2) * sizeof(uint64_t);
+      uint64_t startsBytes = (uint64_t) header->numStarts * POSITION_INTS * sizeof(int32_t);
+      uint64_t goalsBytes = (uint64_t) header->numGoals * POSITION_INTS * sizeof(int32_t);
+      uint64_t distancesBytes = header->hasDistances ? cells * sizeof(int32_t) : 0;
+      valid = borderedCells <= INT_MAX &&
+              header->bitsOffset % sizeof(uint64_t) == 0 &&
+              header->startsOffset % sizeof(int32_t) == 0 &&
+              header->goalsOffset % sizeof(int32_t) == 0 &&
+              header->distancesOffset % sizeof(int32_t) == 0 &&
+              fits(header->bitsOffset, bitsBytes) &&
+              fits(header->startsOffset, startsBytes) &&
+              fits(header->goalsOffset, goalsBytes) &&
+              fits(header->distancesOffset, distancesBytes);
+   }
+   if(!valid) {
+      munmap(region, regionBytes);
+      throw std::runtime_error("Not a binary maze file '" + filename + "'");
+   }
+
+   starts = (int32_t*) (region + header->startsOffset);
+   goals = (int32_t*) (region + header->goalsOffset);
+   distances = (int32_t*) (region + header->distancesOffset);
+   maze = new Maze((uint64_t*) (region + header->bitsOffset), header->rows, header->cols);
+
+   // The searches move from a cell to its neighbours without checking for the edge of the maze,
+   // so the border must be closed, and every start and goal must be inside the maze
+   if(!closedBorder() || !inside(starts, header->numStarts) || !inside(goals, header->numGoals)) {
+      delete maze;
+      maze = nullptr;
+      munmap(region, regionBytes);
+      throw std::runtime_error("Not a binary maze file '" + filename + "'");
+   }
+}
+
+BinaryMazeFile::~BinaryMazeFile() {
+   delete maze;
+   maze = nullptr;
+
+   munmap(region, regionBytes);
+   region = nullptr;
+}
+
+bool BinaryMazeFile::closedBorder() {
+   bool closed = true;
+
+   // The top and bottom rows, then the left and right columns
+   for(int x = -1; closed && x <= maze->getCols(); ++x) {
+      closed = !maze->isOpen(maze->index(x, -1)) && !maze->isOpen(maze->index(x, maze->getRows()));
+   }
+   for(int y = 0; closed && y < maze->getRows(); ++y) {
+      closed = !maze->isOpen(maze->index(-1, y)) && !maze->isOpen(maze->index(maze->getCols(), y));
+   }
+
+   return closed;
+}
+
+bool BinaryMazeFile::inside(int32_t* positions, int count) {
+   bool valid = true;
+
+   for(int i = 0; valid && i < count; ++i) {
+      int x = positions[i * POSITION_INTS];
+      int y = positions[i * POSITION_INTS + 1];
+      valid = x >= 0 && x < maze->getCols() && y >= 0 && y < maze->getRows();
+   }
+
+   return valid;
+}
+
+bool BinaryMazeFile::fits(uint64_t offset, uint64_t bytes) {
+   return offset <= regionBytes && bytes <= regionBytes - offset;
+}
+
+uint64_t BinaryMazeFile::align(uint64_t bytes) {
+   return (bytes + BINARY_MAZE_ALIGNMENT - 1) / BINARY_MAZE_ALIGNMENT * BINARY_MAZE_ALIGNMENT;
+}
+
+void BinaryMazeFile::write(std::string filename, Maze* maze, PDList* starts, PDList* goals,
+                           PDList* reachable) {
+   int rows = maze->getRows();
+   int cols = maze->getCols();
+   long cells = (long) rows * cols;
+
+   // The maze is packed the way a maze copied from a Grid is, whatever maze it is
+   std::vector<uint64_t> bits(Maze::packedBytes(rows, cols) / sizeof(uint64_t), 0);
+   if(maze->getStride() == cols + 2) {
+      std::memcpy(bits.data(), maze->getBits(), bits.size() * sizeof(uint64_t));
+   } else {
+      for(int y = 0; y < rows; ++y) {
+         for(int x = 0; x < cols; ++x) {
+            long bit = (long) (y + 1) * (cols + 2) + x + 1;
+            if(maze->isOpen(maze->index(x, y))) {
+               bits[bit / MAZE_WORD_BITS] |= (uint64_t) 1 << (bit % MAZE_WORD_BITS);
+            }
+         }
+      }
+   }
+
+   std::vector<int32_t> startInts;
+   for(int i = 0; i < starts->size(); ++i) {
+      startInts.push_back(starts->get(i)->getX());
+      startInts.push_back(starts->get(i)->getY());
+   }
+   std::vector<int32_t> goalInts;
+   for(int i = 0; i < goals->size(); ++i) {
+      goalInts.push_back(goals->get(i)->getX());
+      goalInts.push_back(goals->get(i)->getY());
+   }
+
+   // The first start is not in the reachable positions, it is 0 from itself
+   std::vector<int32_t> distances;
+   if(reachable != NULL) {
+      distances.resize(cells, -1);
+      if(starts->size() > 0) {
+         distances[(long) starts->get(0)->getY() * cols + starts->get(0)->getX()] = 0;
+      }
+      for(int i = 0; i < reachable->size(); ++i) {
+         PDPtr position = reachable->get(i);
+         distances[(long) position->getY() * cols + position->getX()] = position->getDistance();
+      }
+   }
+
+   Header header;
+   std::memset(&header, 0, sizeof(header));
+   std::memcpy(header.magic, BINARY_MAZE_MAGIC, sizeof(BINARY_MAZE_MAGIC));
+   header.version = BINARY_MAZE_VERSION;
+   header.rows = rows;
+   header.cols = cols;
+   header.numStarts = starts->size();
+   header.numGoals = goals->size();
+   header.hasDistances = reachable != NULL;
+   header.bitsOffset = align(sizeof(Header));
+   header.startsOffset = align(header.bitsOffset + bits.size() * sizeof(uint64_t));
+   header.goalsOffset = align(header.startsOffset + startInts.size() * sizeof(int32_t));
+   header.distancesOffset = align(header.goalsOffset + goalInts.size() * sizeof(int32_t));
+   header.fileBytes = header.distancesOffset + distances.size() * sizeof(int32_t);
+
+   // Each section is written at its offset, the gaps between them are zeros
+   std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+   std::vector<char> padding(BINARY_MAZE_ALIGNMENT, 0);
+   uint64_t written = 0;
+   auto writeSection = [&](uint64_t offset, const void* data, uint64_t bytes) {
+      file.write(padding.data(), offset - written);
+      file.write((const char*) data, bytes);
+      written = offset + bytes;
+   };
+   writeSection(0, &header, sizeof(header));
+   writeSection(header.bitsOffset, bits.data(), bits.size() * sizeof(uint64_t));
+   writeSection(header.startsOffset, startInts.data(), startInts.size() * sizeof(int32_t));
+   writeSection(header.goalsOffset, goalInts.data(), goalInts.size() * sizeof(int32_t));
+   writeSection(header.distancesOffset, distances.data(), distances.size() * sizeof(int32_t));
+   file.close();
+
+   if(!file) {
+      throw std::runtime_error("Could not write file '" + filename + "'");
+   }
+}
+
+Maze* BinaryMazeFile::getMaze() {
+   return maze;
+}
+
+int BinaryMazeFile::getRows() {
+   return header->rows;
+}
+
+int BinaryMazeFile::getCols() {
+   return header->cols;
+}
+
+int BinaryMazeFile::getNumStarts() {
+   return header->numStarts;
+}
+
+int BinaryMazeFile::getStartX(int i) {
+   return starts[i * POSITION_INTS];
+}
+
+int BinaryMazeFile::getStartY(int i) {
+   return starts[i * POSITION_INTS + 1];
+}
+
+int BinaryMazeFile::getNumGoals() {
+   return header->numGoals;
+}
+
+int BinaryMazeFile::getGoalX(int i) {
+   return goals[i * POSITION_INTS];
+}
+
+int BinaryMazeFile::getGoalY(int i) {
+   return goals[i * POSITION_INTS + 1];
+}
+
+bool BinaryMazeFile::hasDistances() {
+   return header->hasDistances != 0;
+}
+
+int BinaryMazeFile::getDistance(int x, int y) {
+   return distances[(long) y * header->cols + x];
+}
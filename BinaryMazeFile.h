@@ -0,0 +1,131 @@
+#ifndef COSC_ASS_ONE_BINARY_MAZE_FILE
+#define COSC_ASS_ONE_BINARY_MAZE_FILE
+
+#include "Maze.h"
+#include "PDList.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// The first bytes of a binary maze file
+#define BINARY_MAZE_MAGIC "MAZEBIN"
+
+// Version of the layout below, a file with a different version is not read
+#define BINARY_MAZE_VERSION 1
+
+// Every section of the file starts on a multiple of this many bytes
+#define BINARY_MAZE_ALIGNMENT 64
+
+// A maze, its start and goal positions and optionally a distance field, in one binary file.
+//    The file is a header, then these sections, each starting on a multiple of BINARY_MAZE_ALIGNMENT:
+//       the maze, packed exactly the way Maze packs a Grid (Maze::packedBytes(rows, cols) bytes),
+//       the starts and then the goals, as 32 bit (x, y) pairs,
+//       the distance field (optional), the 32 bit distance of cell y * cols + x from
+//       the first start, or -1 if it cannot be reached.
+//    Numbers are stored the way the machine stores them (little-endian on x86 and ARM).
+//    The file is mapped into memory and the Maze it hands out uses the packed maze
+//    where it is, so opening a file hardly depends on its size: nothing is parsed or copied,
+//    pages are read from disk as they are first used. Only the border of the packed maze
+//    is read when the file is opened, so a file that was not written by write() cannot
+//    make a search step outside the maze.
+//    The packed maze only says which cells are open, the other characters are not kept.
+//    The mapping is private: Maze::setCell changes a copy of the page it is on, never the file.
+class BinaryMazeFile {
+public:
+
+   // Map the given binary maze file
+   //    Throws std::runtime_error if it cannot be opened or mapped, or is not a binary maze file
+   //    of this version, or is shorter than its header says, or has an open cell in the border
+   //    of the packed maze or a start or goal outside the maze
+   BinaryMazeFile(std::string filename);
+
+   // Unmap the file
+   //    The Maze from getMaze() is deleted, so no PathPlanning may still be using it
+   ~BinaryMazeFile();
+
+   // Write a binary maze file
+   //    starts and goals may be empty. reachable is the reachable positions of the
+   //    first start with their distances (from PathPlanning::getReachablePositions),
+   //    or NULL to write no distance field.
+   //    Throws std::runtime_error if the file cannot be written
+   static void write(std::string filename, Maze* maze, PDList* starts, PDList* goals, PDList* reachable);
+
+   // The maze, owned by the file
+   //    Pass it to PathPlanning(Maze*) to plan on the file without copying it
+   Maze* getMaze();
+
+   // Number of rows in the maze
+   int getRows();
+
+   // Number of columns in the maze
+   int getCols();
+
+   // The start positions
+   int getNumStarts();
+   int getStartX(int i);
+   int getStartY(int i);
+
+   // The goal positions
+   int getNumGoals();
+   int getGoalX(int i);
+   int getGoalY(int i);
+
+   // Checks if the file has a distance field
+   bool hasDistances();
+
+   // Distance of (x,y) from the first start, or -1 if it cannot be reached
+   //    Only if hasDistances()
+   int getDistance(int x, int y);
+
+   BinaryMazeFile(BinaryMazeFile& other) = delete;
+   BinaryMazeFile& operator=(BinaryMazeFile& other) = delete;
+
+private:
+
+   // The start of the file
+   struct Header {
+      char magic[8];
+      uint32_t version;
+      int32_t rows;
+      int32_t cols;
+      int32_t numStarts;
+      int32_t numGoals;
+      int32_t hasDistances;
+      uint64_t bitsOffset;
+      uint64_t startsOffset;
+      uint64_t goalsOffset;
+      uint64_t distancesOffset;
+      uint64_t fileBytes;
+   };
+
+   // The mapped file
+   char* region;
+   size_t regionBytes;
+
+   // The header at the start of the file
+   Header* header;
+
+   // The sections of the file
+   int32_t* starts;
+   int32_t* goals;
+   int32_t* distances;
+
+   // The view of the packed maze
+   Maze* maze;
+
+   // Round bytes up to a multiple of BINARY_MAZE_ALIGNMENT
+   static uint64_t align(uint64_t bytes);
+
+   // Checks if a section of the given size at the given offset is inside the mapped file
+   //    Nothing is added, so an offset from the file that is near 2^64 cannot wrap around
+   bool fits(uint64_t offset, uint64_t bytes);
+
+   // Checks if every cell of the border around the packed maze is closed
+   bool closedBorder();
+
+   // Checks if every one of count (x, y) pairs is inside the maze
+   bool inside(int32_t* positions, int count);
+};
+
+#endif // COSC_ASS_ONE_BINARY_MAZE_FILE
@@ -0,0 +1,285 @@
+#include "BitboardFlood.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Expand every row between the top and bottom of the frontier when at least
+// one in this many of those rows is in the frontier
+#define BITBOARD_DENSE_RATIO 4
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BITBOARD_HAS_AVX2 1
+#else
+#define BITBOARD_HAS_AVX2 0
+#endif
+
+// Expand one row of the frontier, one word at a time
+//    up, middle and down are the frontier rows above, at and below the row
+//    middle[-1] and middle[words] are the empty words around the row
+//    Returns the OR of every word written, so zero means the row is empty
+static uint64_t expandWords(const uint64_t* up, const uint64_t* middle, const uint64_t* down,
+                            const uint64_t* open, uint64_t* reached, uint64_t* next,
+                            int first, int words) {
+   uint64_t any = 0;
+
+   for(int w = first; w < words; ++w) {
+
+      // Moving right is a shift to the higher bit, the top bit of the word on the left carries in
+      // Moving left is a shift to the lower bit, the bottom bit of the word on the right carries in
+      uint64_t moved = (middle[w] << 1) | (middle[w - 1] >> 63) |
+                       (middle[w] >> 1) | (middle[w + 1] << 63) |
+                       up[w] | down[w];
+      uint64_t found = moved & open[w] & ~reached[w];
+      reached[w] |= found;
+      next[w] = found;
+      any |= found;
+   }
+
+   return any;
+}
+
+#if BITBOARD_HAS_AVX2
+// The same as expandWords, four words at a time, then the words left over one at a time
+__attribute__((target("avx2")))
+static uint64_t expandWordsAvx2(const uint64_t* up, const uint64_t* middle, const uint64_t* down,
+                                const uint64_t* open, uint64_t* reached, uint64_t* next,
+                                int words) {
+   __m256i any = _mm256_setzero_si256();
+   int w = 0;
+
+   for(; w + 4 <= words; w += 4) {
+      __m256i centre = _mm256_loadu_si256((const __m256i*) (middle + w));
+      __m256i left = _mm256_loadu_si256((const __m256i*) (middle + w - 1));
+      __m256i right = _mm256_loadu_si256((const __m256i*) (middle + w + 1));
+
+      __m256i moved = _mm256_or_si256(
+         _mm256_or_si256(_mm256_slli_epi64(centre, 1), _mm256_srli_epi64(left, 63)),
+         _mm256_or_si256(_mm256_srli_epi64(centre, 1), _mm256_slli_epi64(right, 63)));
+      moved = _mm256_or_si256(moved, _mm256_loadu_si256((const __m256i*) (up + w)));
+      moved = _mm256_or_si256(moved, _mm256_loadu_si256((const __m256i*) (down + w)));
+
+      __m256i seen = _mm256_loadu_si256((const __m256i*) (reached + w));
+      __m256i found = _mm256_andnot_si256(seen,
+         _mm256_and_si256(moved, _mm256_loadu_si256((const __m256i*) (open + w))));
+
+      _mm256_storeu_si256((__m256i*) (reached + w), _mm256_or_si256(seen, found));
+      _mm256_storeu_si256((__m256i*) (next + w), found);
+      any = _mm256_or_si256(any, found);
+   }
+
+   uint64_t anyWords[4];
+   _mm256_storeu_si256((__m256i*) anyWords, any);
+   return anyWords[0] | anyWords[1] | anyWords[2] | anyWords[3] |
+          expandWords(up, middle, down, open, reached, next, w, words);
+}
+#endif
+
+BitboardFlood::BitboardFlood(Maze* maze) {
+   this->maze = maze;
+
+   rowWords = (maze->getCols() + BITBOARD_WORD_BITS - 1) / BITBOARD_WORD_BITS;
+   rowStride = rowWords + 2;
+
+   int boardWords = (maze->getRows() + 2) * rowStride;
+   open = new uint64_t[boardWords]();
+   reached = new uint64_t[boardWords]();
+   frontier = new uint64_t[boardWords]();
+   next = new uint64_t[boardWords]();
+   rowLevel.assign(maze->getRows(), -1);
+   frontierFirst.assign(maze->getRows(), rowWords);
+   frontierLast.assign(maze->getRows(), -1);
+   nextFirst.assign(maze->getRows(), rowWords);
+   nextLast.assign(maze->getRows(), -1);
+   distances = new int[maze->size()];
+   levels = 0;
+
+#if BITBOARD_HAS_AVX2
+   avx2 = __builtin_cpu_supports("avx2");
+#else
+   avx2 = false;
+#endif
+
+   // Pack the open cells, one bit per cell
+   for(int y = 0; y < maze->getRows(); ++y) {
+      uint64_t* openRow = row(open, y);
+      for(int x = 0; x < maze->getCols(); ++x) {
+         if(maze->isOpen(maze->index(x, y))) {
+            openRow[x / BITBOARD_WORD_BITS] |= (uint64_t) 1 << (x % BITBOARD_WORD_BITS);
+         }
+      }
+   }
+}
+
+BitboardFlood::~BitboardFlood() {
+   delete[] open;
+   delete[] reached;
+   delete[] frontier;
+   delete[] next;
+   delete[] distances;
+}
+
+std::vector<int>& BitboardFlood::getReached() {
+   return reachedCells;
+}
+
+int BitboardFlood::getLevels() {
+   return levels;
+}
+
+bool BitboardFlood::usesAvx2() {
+   return avx2;
+}
+
+bool BitboardFlood::expandRow(int y, int first, int last) {
+   int words = last - first + 1;
+   uint64_t* up = row(frontier, y - 1) + first;
+   uint64_t* middle = row(frontier, y) + first;
+   uint64_t* down = row(frontier, y + 1) + first;
+   uint64_t* openRow = row(open, y) + first;
+   uint64_t* reachedRow = row(reached, y) + first;
+   uint64_t* nextRow = row(next, y) + first;
+   uint64_t any = 0;
+
+#if BITBOARD_HAS_AVX2
+   if(avx2) {
+      any = expandWordsAvx2(up, middle, down, openRow, reachedRow, nextRow, words);
+   } else
+#endif
+   {
+      any = expandWords(up, middle, down, openRow, reachedRow, nextRow, 0, words);
+   }
+
+   // Remember which words of the row have cells in the next frontier
+   if(any != 0) {
+      int w = 0;
+      while(nextRow[w] == 0) {
+         w++;
+      }
+      nextFirst[y] = first + w;
+      w = words - 1;
+      while(nextRow[w] == 0) {
+         w--;
+      }
+      nextLast[y] = first + w;
+   }
+
+   return any != 0;
+}
+
+void BitboardFlood::flood(int fromX, int fromY) {
+   int rows = maze->getRows();
+   int boardWords = (rows + 2) * rowStride;
+
+   // Forget the last flood
+   std::memset(reached, 0, sizeof(uint64_t) * boardWords);
+   for(int i = 0; i < maze->size(); ++i) {
+      distances[i] = -1;
+   }
+   for(int y = 0; y < rows; ++y) {
+      rowLevel[y] = -1;
+   }
+   reachedCells.clear();
+   frontierRows.clear();
+
+   // Level 0 is the start on its own
+   int startIndex = maze->index(fromX, fromY);
+   uint64_t startBit = (uint64_t) 1 << (fromX % BITBOARD_WORD_BITS);
+   row(frontier, fromY)[fromX / BITBOARD_WORD_BITS] = startBit;
+   row(reached, fromY)[fromX / BITBOARD_WORD_BITS] = startBit;
+   distances[startIndex] = 0;
+   reachedCells.push_back(startIndex);
+   frontierRows.push_back(fromY);
+   frontierFirst[fromY] = fromX / BITBOARD_WORD_BITS;
+   frontierLast[fromY] = fromX / BITBOARD_WORD_BITS;
+   levels = 1;
+
+   while(!frontierRows.empty()) {
+
+      // Only the rows at, above and below a frontier row can have new cells
+      nextRows.clear();
+      int top = rows;
+      int bottom = -1;
+      for(int frontierRow : frontierRows) {
+         top = std::min(top, frontierRow - 1);
+         bottom = std::max(bottom, frontierRow + 1);
+      }
+      top = std::max(top, 0);
+      bottom = std::min(bottom, rows - 1);
+
+      if((int) frontierRows.size() * BITBOARD_DENSE_RATIO >= bottom - top + 1) {
+
+         // Most rows between the top and the bottom of the frontier are in it,
+         // so expand all of them, whole rows at a time
+         for(int y = top; y <= bottom; ++y) {
+            if(expandRow(y, 0, rowWords - 1)) {
+               nextRows.push_back(y);
+            }
+         }
+      }
+      else {
+
+         // The frontier is spread out, so only expand the rows next to it,
+         // and only the words at, left of and right of the frontier words
+         for(int frontierRow : frontierRows) {
+            for(int y = frontierRow - 1; y <= frontierRow + 1; ++y) {
+               if(y >= 0 && y < rows && rowLevel[y] != levels) {
+                  rowLevel[y] = levels;
+
+                  int first = rowWords;
+                  int last = -1;
+                  for(int near = y - 1; near <= y + 1; ++near) {
+                     if(near >= 0 && near < rows && frontierFirst[near] <= frontierLast[near]) {
+                        first = std::min(first, frontierFirst[near] - 1);
+                        last = std::max(last, frontierLast[near] + 1);
+                     }
+                  }
+                  first = std::max(first, 0);
+                  last = std::min(last, rowWords - 1);
+
+                  if(expandRow(y, first, last)) {
+                     nextRows.push_back(y);
+                  }
+               }
+            }
+         }
+      }
+
+      // Every cell in the next frontier is one level further from the start
+      for(int y : nextRows) {
+         uint64_t* nextRow = row(next, y);
+         int rowIndex = maze->index(0, y);
+         for(int w = nextFirst[y]; w <= nextLast[y]; ++w) {
+            uint64_t bits = nextRow[w];
+            while(bits != 0) {
+               int index = rowIndex + w * BITBOARD_WORD_BITS + __builtin_ctzll(bits);
+               distances[index] = levels;
+               reachedCells.push_back(index);
+               bits &= bits - 1;
+            }
+         }
+      }
+
+      // Empty the rows of the old frontier, it becomes the buffer for the level after next
+      // Words outside first to last are already empty
+      for(int y : frontierRows) {
+         uint64_t* frontierRow = row(frontier, y);
+         for(int w = frontierFirst[y]; w <= frontierLast[y]; ++w) {
+            frontierRow[w] = 0;
+         }
+         frontierFirst[y] = rowWords;
+         frontierLast[y] = -1;
+      }
+
+      uint64_t* swap = frontier;
+      frontier = next;
+      next = swap;
+      frontierRows.swap(nextRows);
+      frontierFirst.swap(nextFirst);
+      frontierLast.swap(nextLast);
+
+      if(!frontierRows.empty()) {
+         levels++;
+      }
+   }
+}
@@ -0,0 +1,106 @@
+#ifndef COSC_ASS_ONE_BITBOARD_FLOOD
+#define COSC_ASS_ONE_BITBOARD_FLOOD
+
+#include "DistanceField.h"
+#include "Maze.h"
+
+#include <cstdint>
+#include <vector>
+
+// Number of cells in one word of a bitboard row
+#define BITBOARD_WORD_BITS 64
+
+// Breadth-first flood fill on bitboards.
+//    The open cells, the cells already reached and the current frontier are
+//    each stored as rows of 64-bit words, one bit per cell. A whole BFS level
+//    is expanded at once: the frontier shifted left and right, plus the
+//    frontier rows above and below, masked by the open cells and by the cells
+//    not reached yet. The distance of a cell is the level it was reached in.
+//    Only the rows next to a non-empty frontier row are looked at, and in
+//    those rows only the words next to the frontier words.
+//    Rows are expanded 256 bits at a time with AVX2 when the CPU supports it,
+//    and one 64-bit word at a time otherwise.
+class BitboardFlood : public DistanceField {
+public:
+
+   // Create a flood fill for the given maze, the maze is not owned by the flood fill
+   //    The open cells of the maze are packed into bits once, here
+   BitboardFlood(Maze* maze);
+
+   // Clean-up
+   ~BitboardFlood();
+
+   // Flood the maze from (fromX,fromY)
+   void flood(int fromX, int fromY) override;
+
+   // Distance from the start of the cell at the given maze index, or -1 if it was not reached
+   int getDistance(int index) override { return distances[index]; }
+
+   // Maze indexes of the cells reached by the last flood, in the order of their distance
+   //    The start is the first cell
+   std::vector<int>& getReached() override;
+
+   // Number of levels (the largest distance plus one) of the last flood
+   int getLevels();
+
+   // Checks if the rows are expanded with AVX2
+   bool usesAvx2();
+
+   BitboardFlood(BitboardFlood& other) = delete;
+   BitboardFlood& operator=(BitboardFlood& other) = delete;
+
+private:
+
+   // The maze being flooded
+   Maze* maze;
+
+   // Number of words holding the cells of one row
+   int rowWords;
+
+   // Number of words from one row to the next
+   //    Every row has an empty word before and after it, and there is an empty row
+   //    above and below the maze, so shifting never needs a bounds check
+   int rowStride;
+
+   // The bitboards: open cells, cells reached, the current frontier and the next frontier
+   uint64_t* open;
+   uint64_t* reached;
+   uint64_t* frontier;
+   uint64_t* next;
+
+   // Rows of the current frontier that have a cell in them, and of the next frontier
+   std::vector<int> frontierRows;
+   std::vector<int> nextRows;
+
+   // First and last word with a cell in them, for every row of the current and next frontier
+   //    An empty row has first greater than last
+   std::vector<int> frontierFirst;
+   std::vector<int> frontierLast;
+   std::vector<int> nextFirst;
+   std::vector<int> nextLast;
+
+   // The level a row was last added to the rows to expand in, so it is only added once
+   std::vector<int> rowLevel;
+
+   // Distance of every cell, by maze index
+   int* distances;
+
+   // Maze indexes of the cells reached, in the order of their distance
+   std::vector<int> reachedCells;
+
+   // Number of levels of the last flood
+   int levels;
+
+   // Checks if the rows are expanded with AVX2
+   bool avx2;
+
+   // The first word (after the empty word) of the given bitboard row, row -1 and row rows are the empty rows
+   uint64_t* row(uint64_t* board, int y) { return board + (y + 1) * rowStride + 1; }
+
+   // Work out the next frontier of row y from the current frontier
+   //    Only words first to last are worked out, the rest of the row stays empty
+   //    Returns true if the row has any cell in the next frontier
+   bool expandRow(int y, int first, int last);
+};
+
+#endif // COSC_ASS_ONE_BITBOARD_FLOOD
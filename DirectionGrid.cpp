@@ -0,0 +1,11 @@
+#include "DirectionGrid.h"
+
+DirectionGrid::DirectionGrid(int numCells) {
+   numBytes = (numCells + DIRECTIONS_PER_BYTE - 1) / DIRECTIONS_PER_BYTE;
+   directions = new unsigned char[numBytes]();
+}
+
+DirectionGrid::~DirectionGrid() {
+   delete[] directions;
+   directions = nullptr;
+}
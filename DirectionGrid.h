@@ -0,0 +1,50 @@
+#ifndef COSC_ASS_ONE_DIRECTION_GRID
+#define COSC_ASS_ONE_DIRECTION_GRID
+
+// Number of bits stored for each cell
+#define DIRECTION_BITS 2
+
+// Number of cells that share one byte
+#define DIRECTIONS_PER_BYTE 4
+
+// One direction (0 to 3, the LRUD move index) for every cell of a maze, packed 2 bits per cell.
+//    A search stores the move that first reached a cell, so the path can be
+//    traced back from any cell by undoing one move at a time.
+class DirectionGrid {
+public:
+
+   // Create a grid for the given number of cells, every cell starts as direction 0
+   DirectionGrid(int numCells);
+
+   // Clean-up
+   ~DirectionGrid();
+
+   // Store the direction for the cell at the given index
+   void set(int index, int direction) {
+      unsigned char& byte = directions[index / DIRECTIONS_PER_BYTE];
+      int shift = (index % DIRECTIONS_PER_BYTE) * DIRECTION_BITS;
+      byte = (unsigned char) ((byte & ~(3 << shift)) | (direction << shift));
+   }
+
+   // The direction stored for the cell at the given index
+   int get(int index) const {
+      int shift = (index % DIRECTIONS_PER_BYTE) * DIRECTION_BITS;
+      return (directions[index / DIRECTIONS_PER_BYTE] >> shift) & 3;
+   }
+
+   // Number of bytes used by the grid
+   int bytes() const { return numBytes; }
+
+   DirectionGrid(DirectionGrid& other) = delete;
+   DirectionGrid& operator=(DirectionGrid& other) = delete;
+
+private:
+
+   // The packed directions
+   unsigned char* directions;
+
+   // Number of bytes in directions
+   int numBytes;
+};
+
+#endif // COSC_ASS_ONE_DIRECTION_GRID
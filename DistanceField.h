@@ -0,0 +1,25 @@
+#ifndef COSC_ASS_ONE_DISTANCE_FIELD
+#define COSC_ASS_ONE_DISTANCE_FIELD
+
+#include <vector>
+
+// A flood fill that works out the distance from a start to every reachable cell of a maze.
+//    Implemented by the flood fills that do not keep the move that reached each cell
+//    (BitboardFlood and ParallelFlood), so PathPlanning can use them the same way.
+class DistanceField {
+public:
+
+   virtual ~DistanceField() {}
+
+   // Flood the maze from (fromX,fromY)
+   virtual void flood(int fromX, int fromY) = 0;
+
+   // Distance from the start of the cell at the given maze index, or -1 if it was not reached
+   virtual int getDistance(int index) = 0;
+
+   // Maze indexes of the cells reached by the last flood, in the order of their distance
+   //    The start is the first cell
+   virtual std::vector<int>& getReached() = 0;
+};
+
+#endif // COSC_ASS_ONE_DISTANCE_FIELD
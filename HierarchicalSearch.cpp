@@ -0,0 +1,386 @@
+#include "HierarchicalSearch.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <thread>
+
+// Marks a cell or node that has not been reached
+#define NOT_REACHED -1
+
+HierarchicalSearch::HierarchicalSearch(Maze* maze, int clusterSize, int numThreads) {
+   this->maze = maze;
+   this->clusterSize = clusterSize < 1 ? 1 : clusterSize;
+   clustersX = (maze->getCols() + this->clusterSize - 1) / this->clusterSize;
+   clustersY = (maze->getRows() + this->clusterSize - 1) / this->clusterSize;
+   clusterNodes.resize((long) clustersX * clustersY);
+   currentStamp = 0;
+   nodesExpanded = 0;
+
+   // The entrances are found on this thread, they are quick and every cluster edge is shared by two clusters
+   findEntrances();
+   nodeAt.clear();
+
+   // The edges inside a cluster only need its own cells, so the clusters are shared out between threads
+   std::atomic<int> nextCluster(0);
+   std::vector<std::thread> threads;
+   for(int i = 1; i < numThreads; ++i) {
+      threads.push_back(std::thread(&HierarchicalSearch::buildClusters, this, std::ref(nextCluster)));
+   }
+   buildClusters(nextCluster);
+   for(std::thread& thread : threads) {
+      thread.join();
+   }
+
+   costs.resize(nodeCells.size());
+   parents.resize(nodeCells.size());
+   stamps.resize(nodeCells.size(), 0);
+}
+
+HierarchicalSearch::~HierarchicalSearch() {
+}
+
+int HierarchicalSearch::getNodesExpanded() {
+   return nodesExpanded;
+}
+
+int HierarchicalSearch::getNumNodes() {
+   return nodeCells.size();
+}
+
+long HierarchicalSearch::getNumEdges() {
+   long numEdges = 0;
+   for(std::vector<Edge>& nodeEdges : edges) {
+      numEdges += nodeEdges.size();
+   }
+   return numEdges;
+}
+
+void HierarchicalSearch::findEntrances() {
+   int rows = maze->getRows();
+   int cols = maze->getCols();
+
+   for(int cy = 0; cy < clustersY; ++cy) {
+      for(int cx = 0; cx < clustersX; ++cx) {
+         int x = cx * clusterSize;
+         int y = cy * clusterSize;
+         int width = std::min(clusterSize, cols - x);
+         int height = std::min(clusterSize, rows - y);
+
+         // The right edge, down the last column of this cluster and the first column of the next
+         if(cx + 1 < clustersX) {
+            scanEdge(maze->index(x + width - 1, y), maze->getMove(3), maze->getMove(1), height);
+         }
+
+         // The bottom edge, along the last row of this cluster and the first row of the next
+         if(cy + 1 < clustersY) {
+            scanEdge(maze->index(x, y + height - 1), maze->getMove(1), maze->getMove(3), width);
+         }
+      }
+   }
+}
+
+void HierarchicalSearch::scanEdge(int fromIndex, int along, int across, int length) {
+   int runStart = 0;
+
+   // i == length closes the last run
+   for(int i = 0; i <= length; ++i) {
+      int index = fromIndex + i * along;
+      bool open = i < length && maze->isOpen(index) && maze->isOpen(index + across);
+
+      if(!open) {
+         int runLength = i - runStart;
+         if(runLength >= HPA_LONG_ENTRANCE) {
+            int first = fromIndex + runStart * along;
+            int last = fromIndex + (i - 1) * along;
+            addEntrance(first, first + across);
+            addEntrance(last, last + across);
+         } else if(runLength > 0) {
+            int middle = fromIndex + (runStart + (runLength - 1) / 2) * along;
+            addEntrance(middle, middle + across);
+         }
+         runStart = i + 1;
+      }
+   }
+}
+
+void HierarchicalSearch::addEntrance(int index, int otherIndex) {
+   int node = nodeFor(index);
+   int otherNode = nodeFor(otherIndex);
+   edges[node].push_back({otherNode, 1});
+   edges[otherNode].push_back({node, 1});
+}
+
+int HierarchicalSearch::nodeFor(int index) {
+   int node = 0;
+
+   // A cell in the corner of a cluster can be on two entrances, it only gets one node
+   auto found = nodeAt.find(index);
+   if(found != nodeAt.end()) {
+      node = found->second;
+   } else {
+      node = nodeCells.size();
+      nodeAt[index] = node;
+      nodeCells.push_back(index);
+      nodeClusters.push_back(clusterOf(index));
+      clusterNodes[clusterOf(index)].push_back(node);
+      edges.push_back(std::vector<Edge>());
+   }
+
+   return node;
+}
+
+void HierarchicalSearch::buildClusters(std::atomic<int>& nextCluster) {
+
+   // Each thread floods with its own scratch memory, and only adds edges to the nodes of its clusters
+   std::vector<int> distances(clusterSize * clusterSize);
+   std::vector<int> cellQueue;
+
+   int cluster = nextCluster.fetch_add(1);
+   while(cluster < (int) clusterNodes.size()) {
+      std::vector<int>& nodes = clusterNodes[cluster];
+
+      for(int node : nodes) {
+         floodCluster(nodeCells[node], distances, cellQueue);
+         for(int other : nodes) {
+            int distance = distances[localIndex(nodeCells[other])];
+            if(other != node && distance != NOT_REACHED) {
+               edges[node].push_back({other, distance});
+            }
+         }
+      }
+
+      cluster = nextCluster.fetch_add(1);
+   }
+}
+
+int HierarchicalSearch::clusterOf(int index) {
+   return (maze->getY(index) / clusterSize) * clustersX + maze->getX(index) / clusterSize;
+}
+
+int HierarchicalSearch::localIndex(int index) {
+   return (maze->getY(index) % clusterSize) * clusterSize + maze->getX(index) % clusterSize;
+}
+
+int HierarchicalSearch::floodCluster(int fromIndex, std::vector<int>& distances,
+                                     std::vector<int>& cellQueue) {
+
+   std::fill(distances.begin(), distances.end(), NOT_REACHED);
+   cellQueue.clear();
+
+   // The cells are looked at by their position in the cluster, so the edges of the cluster are easy to check
+   // The cluster may be cut short by the right or bottom edge of the maze
+   int cornerX = maze->getX(fromIndex) / clusterSize * clusterSize;
+   int cornerY = maze->getY(fromIndex) / clusterSize * clusterSize;
+   int width = std::min(clusterSize, maze->getCols() - cornerX);
+   int height = std::min(clusterSize, maze->getRows() - cornerY);
+   int corner = maze->index(cornerX, cornerY);
+
+   // {Left, Right, Up, Down}, the same order as Maze::getMove
+   int moveHorizontal[LRUD] = {-1, 1, 0, 0};
+   int moveVertical[LRUD] = {0, 0, -1, 1};
+
+   distances[localIndex(fromIndex)] = 0;
+   cellQueue.push_back(localIndex(fromIndex));
+
+   // The queue is read from the front as it is added to, so it never has to be emptied
+   for(unsigned int checked = 0; checked < cellQueue.size(); ++checked) {
+      int local = cellQueue[checked];
+      int x = local % clusterSize;
+      int y = local / clusterSize;
+      int distance = distances[local];
+
+      for(int i = 0; i < LRUD; ++i) {
+         int nextX = x + moveHorizontal[i];
+         int nextY = y + moveVertical[i];
+         int next = local + moveHorizontal[i] + moveVertical[i] * clusterSize;
+
+         if(nextX >= 0 && nextX < width && nextY >= 0 && nextY < height &&
+            distances[next] == NOT_REACHED &&
+            maze->isOpen(corner + nextY * maze->getStride() + nextX)) {
+
+            distances[next] = distance + 1;
+            cellQueue.push_back(next);
+         }
+      }
+   }
+
+   return cellQueue.size();
+}
+
+void HierarchicalSearch::traceCluster(int fromIndex, std::vector<int>& distances,
+                                      std::vector<int>& cells) {
+   int cluster = clusterOf(fromIndex);
+   int index = fromIndex;
+   int distance = distances[localIndex(index)];
+   cells.push_back(index);
+
+   // Step to any neighbour in the cluster that is one closer, until the cell flooded from
+   // The cell flooded from does not have to be open, so only the distances are looked at
+   while(distance > 0) {
+      bool stepped = false;
+      for(int i = 0; i < LRUD && !stepped; ++i) {
+         int next = index + maze->getMove(i);
+         int x = maze->getX(next);
+         int y = maze->getY(next);
+         bool inMaze = x >= 0 && x < maze->getCols() && y >= 0 && y < maze->getRows();
+
+         if(inMaze && clusterOf(next) == cluster && distances[localIndex(next)] == distance - 1) {
+            index = next;
+            stepped = true;
+         }
+      }
+      distance--;
+      cells.push_back(index);
+   }
+}
+
+void HierarchicalSearch::nextStamp() {
+
+   // When the stamp runs out, clear the stamps and start counting again
+   if(currentStamp == INT_MAX) {
+      std::fill(stamps.begin(), stamps.end(), 0);
+      currentStamp = 0;
+   }
+   currentStamp++;
+}
+
+bool HierarchicalSearch::openAfter(const OpenNode& a, const OpenNode& b) {
+   return a.estimate > b.estimate || (a.estimate == b.estimate && a.cost < b.cost);
+}
+
+bool HierarchicalSearch::findPath(int fromX, int fromY, int toX, int toY, PDList* path) {
+
+   nextStamp();
+   open.clear();
+   nodesExpanded = 0;
+
+   // A goal outside the maze can never be reached
+   if(toX < 0 || toX >= maze->getCols() || toY < 0 || toY >= maze->getRows()) {
+      return false;
+   }
+
+   int startIndex = maze->index(fromX, fromY);
+   int goalIndex = maze->index(toX, toY);
+
+   // The start is the whole path to itself, even on a closed cell, the same as the other searches
+   if(startIndex == goalIndex) {
+      path->addBack(fromX, fromY, 0);
+      return true;
+   }
+
+   // A goal on a closed cell can never be reached
+   if(!maze->isOpen(goalIndex)) {
+      return false;
+   }
+   int startCluster = clusterOf(startIndex);
+   int goalCluster = clusterOf(goalIndex);
+
+   // Join the start and the goal to the nodes of their clusters
+   startDistances.resize(clusterSize * clusterSize);
+   goalDistances.resize(clusterSize * clusterSize);
+   segmentDistances.resize(clusterSize * clusterSize);
+   nodesExpanded += floodCluster(startIndex, startDistances, queue);
+   nodesExpanded += floodCluster(goalIndex, goalDistances, queue);
+
+   // The length of the best path found so far, and the last node on it (-1 for a path that uses no nodes)
+   int best = INT_MAX;
+   int bestNode = NOT_REACHED;
+   if(startCluster == goalCluster && startDistances[localIndex(goalIndex)] != NOT_REACHED) {
+      best = startDistances[localIndex(goalIndex)];
+   }
+
+   for(int node : clusterNodes[startCluster]) {
+      int cost = startDistances[localIndex(nodeCells[node])];
+      if(cost != NOT_REACHED) {
+         costs[node] = cost;
+         parents[node] = NOT_REACHED;
+         stamps[node] = currentStamp;
+         open.push_back({cost + std::abs(toX - maze->getX(nodeCells[node])) +
+                         std::abs(toY - maze->getY(nodeCells[node])), cost, node});
+         std::push_heap(open.begin(), open.end(), openAfter);
+      }
+   }
+
+   // A* on the abstract graph, until no node can lead to a shorter path than the best one
+   while(!open.empty() && open.front().estimate < best) {
+      std::pop_heap(open.begin(), open.end(), openAfter);
+      OpenNode entry = open.back();
+      open.pop_back();
+
+      // A shorter way to this node was found after this entry was added, skip it
+      if(entry.cost == costs[entry.node]) {
+         nodesExpanded++;
+
+         if(nodeClusters[entry.node] == goalCluster) {
+            int toGoal = goalDistances[localIndex(nodeCells[entry.node])];
+            if(toGoal != NOT_REACHED && entry.cost + toGoal < best) {
+               best = entry.cost + toGoal;
+               bestNode = entry.node;
+            }
+         }
+
+         for(Edge& edge : edges[entry.node]) {
+            int cost = entry.cost + edge.cost;
+            if(stamps[edge.to] != currentStamp || cost < costs[edge.to]) {
+               stamps[edge.to] = currentStamp;
+               costs[edge.to] = cost;
+               parents[edge.to] = entry.node;
+
+               int cell = nodeCells[edge.to];
+               int heuristic = std::abs(toX - maze->getX(cell)) + std::abs(toY - maze->getY(cell));
+               open.push_back({cost + heuristic, cost, edge.to});
+               std::push_heap(open.begin(), open.end(), openAfter);
+            }
+         }
+      }
+   }
+
+   if(best == INT_MAX) {
+      return false;
+   }
+
+   // Fill in the cells from the start to the goal, one cluster at a time
+   std::vector<int> cells;
+   if(bestNode == NOT_REACHED) {
+      traceCluster(goalIndex, startDistances, cells);
+      std::reverse(cells.begin(), cells.end());
+   } else {
+      std::vector<int> nodes;
+      for(int node = bestNode; node != NOT_REACHED; node = parents[node]) {
+         nodes.push_back(node);
+      }
+      std::reverse(nodes.begin(), nodes.end());
+
+      // From the start to the first node, traced backwards
+      traceCluster(nodeCells[nodes[0]], startDistances, cells);
+      std::reverse(cells.begin(), cells.end());
+
+      // An entrance is a single move, an edge inside a cluster is flooded again to find its cells
+      std::vector<int> segment;
+      for(unsigned int i = 1; i < nodes.size(); ++i) {
+         int from = nodeCells[nodes[i - 1]];
+         int to = nodeCells[nodes[i]];
+         if(nodeClusters[nodes[i - 1]] != nodeClusters[nodes[i]]) {
+            cells.push_back(to);
+         } else {
+            nodesExpanded += floodCluster(to, segmentDistances, queue);
+            segment.clear();
+            traceCluster(from, segmentDistances, segment);
+            cells.insert(cells.end(), segment.begin() + 1, segment.end());
+         }
+      }
+
+      // From the last node to the goal
+      segment.clear();
+      traceCluster(nodeCells[bestNode], goalDistances, segment);
+      cells.insert(cells.end(), segment.begin() + 1, segment.end());
+   }
+
+   // The path goes from the goal back to the start, the same as the other searches
+   for(int i = cells.size() - 1; i >= 0; --i) {
+      path->addBack(maze->getX(cells[i]), maze->getY(cells[i]), i);
+   }
+
+   return true;
+}
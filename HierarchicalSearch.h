@@ -0,0 +1,169 @@
+#ifndef COSC_ASS_ONE_HIERARCHICAL_SEARCH
+#define COSC_ASS_ONE_HIERARCHICAL_SEARCH
+
+#include "Maze.h"
+#include "PDList.h"
+
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+// Default width and height of a cluster, in cells
+#define HPA_CLUSTER_SIZE 16
+
+// An entrance with at least this many cells gets a node at each end instead of one in the middle
+#define HPA_LONG_ENTRANCE 6
+
+// Hierarchical path-finding (HPA*) on a Maze, for many long queries on the same maze.
+//    The maze is cut into square clusters. Where a run of open cells crosses
+//    the edge between two clusters (an entrance), a node is put on each side,
+//    joined by an edge of length 1. Inside every cluster, the distance between
+//    each pair of its nodes is found once with a flood fill that stays in the cluster.
+//    This abstract graph is built once, the clusters are shared out between threads.
+//    A query floods the start's and the goal's clusters to join them to the graph,
+//    runs A* on the graph, which has far fewer nodes than the maze has cells,
+//    then fills in the cells of the path one cluster at a time.
+//    The path always reaches the goal if it can be reached, but only crosses the
+//    clusters at their nodes, so it can be a few cells longer than a shortest path.
+class HierarchicalSearch {
+public:
+
+   // Build the abstract graph for the given maze, the maze is not owned by the search
+   //    The clusters are clusterSize x clusterSize cells, and are shared out between numThreads threads
+   HierarchicalSearch(Maze* maze, int clusterSize, int numThreads);
+
+   // Clean-up
+   ~HierarchicalSearch();
+
+   // Find a path from (fromX,fromY) to (toX,toY)
+   //    The path is added to the given list from the goal back to the start,
+   //    each position with its distance from the start, the same as PathPlanning::getPath.
+   //    Returns false and adds nothing if the goal cannot be reached.
+   bool findPath(int fromX, int fromY, int toX, int toY, PDList* path);
+
+   // Number of nodes taken off the open list, plus the cells flooded, by the last search
+   int getNodesExpanded();
+
+   // Number of nodes in the abstract graph
+   int getNumNodes();
+
+   // Number of edges in the abstract graph, counting each direction
+   long getNumEdges();
+
+   HierarchicalSearch(HierarchicalSearch& other) = delete;
+   HierarchicalSearch& operator=(HierarchicalSearch& other) = delete;
+
+private:
+
+   // An edge of the abstract graph
+   struct Edge {
+      // The node it goes to
+      int to;
+
+      // Number of moves along the edge
+      int cost;
+   };
+
+   // An entry in the open list
+   struct OpenNode {
+      // Estimated length of a path through this node (cost + heuristic)
+      int estimate;
+
+      // Distance from the start when the entry was added
+      int cost;
+
+      // The node
+      int node;
+   };
+
+   // The maze being searched
+   Maze* maze;
+
+   // Width and height of a cluster
+   int clusterSize;
+
+   // Number of clusters across and down the maze
+   int clustersX;
+   int clustersY;
+
+   // Maze index of the cell of every node
+   std::vector<int> nodeCells;
+
+   // The cluster every node is in
+   std::vector<int> nodeClusters;
+
+   // The nodes of every cluster
+   std::vector<std::vector<int>> clusterNodes;
+
+   // The edges leaving every node
+   std::vector<std::vector<Edge>> edges;
+
+   // The node on the cell at a maze index, while the nodes are being made
+   std::unordered_map<int, int> nodeAt;
+
+   // Best known distance from the start for every node
+   std::vector<int> costs;
+
+   // The node every node was reached from, or -1 if it was reached straight from the start
+   std::vector<int> parents;
+
+   // The search a node was last seen in, costs and parents are only valid if this matches currentStamp
+   std::vector<int> stamps;
+
+   // Stamp of the current search
+   int currentStamp;
+
+   // The open list, a binary heap ordered by estimate
+   std::vector<OpenNode> open;
+
+   // Distances in the cluster of the start, the goal, and the cluster being filled in
+   std::vector<int> startDistances;
+   std::vector<int> goalDistances;
+   std::vector<int> segmentDistances;
+
+   // The queue of the cluster flood fills
+   std::vector<int> queue;
+
+   // Number of nodes and cells expanded by the last search
+   int nodesExpanded;
+
+   // Make the nodes and edges of the entrances between every pair of neighbouring clusters
+   void findEntrances();
+
+   // Look along the edge between two clusters, fromIndex + i * along is on one side
+   //    and fromIndex + i * along + across is on the other, for i from 0 to length - 1
+   void scanEdge(int fromIndex, int along, int across, int length);
+
+   // Join the cells at the given maze indexes with an edge in each direction
+   void addEntrance(int index, int otherIndex);
+
+   // The node on the cell at the given maze index, made if there is not one yet
+   int nodeFor(int index);
+
+   // Add the edges inside the clusters taken from nextCluster until there are none left
+   //    Runs on every build thread, each cluster is only ever taken by one thread
+   void buildClusters(std::atomic<int>& nextCluster);
+
+   // The cluster the cell at the given maze index is in
+   int clusterOf(int index);
+
+   // Position of the cell at the given maze index in its cluster, from 0 to clusterSize^2 - 1
+   int localIndex(int index);
+
+   // Flood fill from the given maze index without leaving its cluster
+   //    distances gets the distance of every cell of the cluster by localIndex, or -1 if not reached
+   //    Returns the number of cells reached
+   int floodCluster(int fromIndex, std::vector<int>& distances, std::vector<int>& cellQueue);
+
+   // Add the cells from fromIndex down the distances of floodCluster to the cell it flooded from
+   void traceCluster(int fromIndex, std::vector<int>& distances, std::vector<int>& cells);
+
+   // Start a new search, making every node unseen
+   void nextStamp();
+
+   // Order of the heap, the entry with the smallest estimate comes first
+   //    Equal estimates prefer the entry furthest from the start, it is closer to the goal
+   static bool openAfter(const OpenNode& a, const OpenNode& b);
+};
+
+#endif // COSC_ASS_ONE_HIERARCHICAL_SEARCH
@@ -0,0 +1,198 @@
+#include "JumpPointSearch.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+// Directions in the LRUD order of Maze::getMove
+#define MOVE_LEFT  0
+#define MOVE_RIGHT 1
+#define MOVE_UP    2
+#define MOVE_DOWN  3
+
+// Marks a jump point with no parent (the start)
+#define NO_PARENT -1
+
+JumpPointSearch::JumpPointSearch(Maze* maze) {
+   this->maze = maze;
+   costs = new int[maze->size()];
+   parents = new int[maze->size()];
+   stamps = new int[maze->size()]();
+   currentStamp = 0;
+   goalIndex = 0;
+   nodesExpanded = 0;
+}
+
+JumpPointSearch::~JumpPointSearch() {
+   delete[] costs;
+   costs = nullptr;
+   delete[] parents;
+   parents = nullptr;
+   delete[] stamps;
+   stamps = nullptr;
+}
+
+int JumpPointSearch::getNodesExpanded() {
+   return nodesExpanded;
+}
+
+void JumpPointSearch::nextStamp() {
+
+   // When the stamp runs out, clear the stamps and start counting again
+   if(currentStamp == INT_MAX) {
+      for(int i = 0; i < maze->size(); ++i) {
+         stamps[i] = 0;
+      }
+      currentStamp = 0;
+   }
+   currentStamp++;
+}
+
+bool JumpPointSearch::openAfter(const OpenNode& a, const OpenNode& b) {
+   return a.estimate > b.estimate || (a.estimate == b.estimate && a.cost < b.cost);
+}
+
+int JumpPointSearch::manhattan(int a, int b) {
+   return std::abs(maze->getX(a) - maze->getX(b)) + std::abs(maze->getY(a) - maze->getY(b));
+}
+
+int JumpPointSearch::jumpHorizontal(int index, int move) {
+   int stride = maze->getStride();
+   int found = -1;
+
+   while(found == -1 && maze->isOpen(index)) {
+
+      // A cell above or below that can not be reached from the cell behind has to be reached from here
+      bool forced = (maze->isOpen(index - stride) && !maze->isOpen(index - stride - move)) ||
+                    (maze->isOpen(index + stride) && !maze->isOpen(index + stride - move));
+
+      if(index == goalIndex || forced) {
+         found = index;
+      }
+      index += move;
+   }
+
+   return found;
+}
+
+int JumpPointSearch::jumpVertical(int index, int move) {
+   int found = -1;
+
+   while(found == -1 && maze->isOpen(index)) {
+
+      // A cell to the left or right that can not be reached from the cell behind has to be reached from here
+      bool forced = (maze->isOpen(index - 1) && !maze->isOpen(index - 1 - move)) ||
+                    (maze->isOpen(index + 1) && !maze->isOpen(index + 1 - move));
+
+      // Something worth turning for along this row also makes this cell a jump point
+      if(index == goalIndex || forced ||
+         jumpHorizontal(index + 1, 1) != -1 || jumpHorizontal(index - 1, -1) != -1) {
+         found = index;
+      }
+      index += move;
+   }
+
+   return found;
+}
+
+void JumpPointSearch::jumpFrom(int index, int cost, int direction) {
+   int move = maze->getMove(direction);
+   int found = -1;
+
+   if(direction == MOVE_LEFT || direction == MOVE_RIGHT) {
+      found = jumpHorizontal(index + move, move);
+   } else {
+      found = jumpVertical(index + move, move);
+   }
+
+   if(found != -1) {
+      int foundCost = cost + manhattan(index, found);
+      if(stamps[found] != currentStamp || foundCost < costs[found]) {
+         stamps[found] = currentStamp;
+         costs[found] = foundCost;
+         parents[found] = index;
+         open.push_back({foundCost + manhattan(found, goalIndex), foundCost, found});
+         std::push_heap(open.begin(), open.end(), openAfter);
+      }
+   }
+}
+
+bool JumpPointSearch::findPath(int fromX, int fromY, int toX, int toY, PDList* path) {
+
+   nextStamp();
+   open.clear();
+   nodesExpanded = 0;
+
+   // A goal outside the maze can never be reached
+   if(toX < 0 || toX >= maze->getCols() || toY < 0 || toY >= maze->getRows()) {
+      return false;
+   }
+
+   int startIndex = maze->index(fromX, fromY);
+   goalIndex = maze->index(toX, toY);
+
+   costs[startIndex] = 0;
+   parents[startIndex] = NO_PARENT;
+   stamps[startIndex] = currentStamp;
+   open.push_back({manhattan(startIndex, goalIndex), 0, startIndex});
+
+   bool found = false;
+   while(!open.empty() && !found) {
+      std::pop_heap(open.begin(), open.end(), openAfter);
+      OpenNode node = open.back();
+      open.pop_back();
+
+      // A shorter way to this jump point was found after this entry was added, skip it
+      if(node.cost == costs[node.index]) {
+         nodesExpanded++;
+
+         if(node.index == goalIndex) {
+            found = true;
+         }
+         else if(parents[node.index] == NO_PARENT) {
+
+            // The start looks in every direction
+            for(int i = 0; i < LRUD; ++i) {
+               jumpFrom(node.index, node.cost, i);
+            }
+         }
+         else {
+
+            // Keep going the same way, or turn to either side, but never go back
+            int parent = parents[node.index];
+            if(maze->getY(parent) == maze->getY(node.index)) {
+               jumpFrom(node.index, node.cost, parent < node.index ? MOVE_RIGHT : MOVE_LEFT);
+               jumpFrom(node.index, node.cost, MOVE_UP);
+               jumpFrom(node.index, node.cost, MOVE_DOWN);
+            } else {
+               jumpFrom(node.index, node.cost, parent < node.index ? MOVE_DOWN : MOVE_UP);
+               jumpFrom(node.index, node.cost, MOVE_LEFT);
+               jumpFrom(node.index, node.cost, MOVE_RIGHT);
+            }
+         }
+      }
+   }
+
+   // Walk back along the straight lines between the jump points, adding every cell
+   if(found) {
+      int index = goalIndex;
+      int distance = costs[goalIndex];
+
+      while(index != startIndex) {
+         int parent = parents[index];
+         int step = maze->getY(parent) == maze->getY(index) ? 1 : maze->getStride();
+         if(parent > index) {
+            step = -step;
+         }
+
+         for(; index != parent; index -= step) {
+            path->addBack(maze->getX(index), maze->getY(index), distance);
+            distance--;
+         }
+      }
+
+      path->addBack(fromX, fromY, 0);
+   }
+
+   return found;
+}
@@ -0,0 +1,96 @@
+#ifndef COSC_ASS_ONE_JUMP_POINT_SEARCH
+#define COSC_ASS_ONE_JUMP_POINT_SEARCH
+
+#include "Maze.h"
+#include "PDList.h"
+
+#include <vector>
+
+// Jump Point Search on a Maze, for the four LRUD moves.
+//    A* that only puts "jump points" on the open list. From a jump point the
+//    search jumps in a straight line, skipping every cell that can be reached
+//    just as cheaply some other way, and only stops at the goal or at a cell
+//    with a forced neighbour (a neighbour that is only reachable optimally by
+//    turning there). Vertical jumps also look left and right along every row
+//    they pass, and stop if either side finds a jump point.
+//    In large open rooms most cells are skipped, so far fewer cells go through
+//    the open list than with AStarSearch, and the path is still a shortest path.
+//    Like AStarSearch, the scratch arrays are kept between searches and a cell
+//    only counts as seen if its stamp matches the current search.
+class JumpPointSearch {
+public:
+
+   // Create a search for the given maze, the maze is not owned by the search
+   JumpPointSearch(Maze* maze);
+
+   // Clean-up
+   ~JumpPointSearch();
+
+   // Find a shortest path from (fromX,fromY) to (toX,toY)
+   //    The path is added to the given list from the goal back to the start,
+   //    each position with its distance from the start, the same as PathPlanning::getPath.
+   //    The straight lines between jump points are filled in, so every cell of the path is listed.
+   //    Returns false and adds nothing if the goal cannot be reached.
+   bool findPath(int fromX, int fromY, int toX, int toY, PDList* path);
+
+   // Number of jump points taken off the open list by the last search
+   int getNodesExpanded();
+
+   JumpPointSearch(JumpPointSearch& other) = delete;
+   JumpPointSearch& operator=(JumpPointSearch& other) = delete;
+
+private:
+
+   // An entry in the open list, the same as in AStarSearch
+   struct OpenNode {
+      int estimate;
+      int cost;
+      int index;
+   };
+
+   // The maze being searched
+   Maze* maze;
+
+   // Best known distance from the start for every jump point
+   int* costs;
+
+   // The jump point every jump point was reached from
+   int* parents;
+
+   // The search a cell was last seen in, costs and parents are only valid if this matches currentStamp
+   int* stamps;
+
+   // Stamp of the current search
+   int currentStamp;
+
+   // The open list, a binary heap ordered by estimate
+   std::vector<OpenNode> open;
+
+   // Maze index of the goal of the current search
+   int goalIndex;
+
+   // Number of jump points taken off the open list by the last search
+   int nodesExpanded;
+
+   // Start a new search, making every cell unseen
+   void nextStamp();
+
+   // Jump left (move -1) or right (move 1), starting at index
+   //    Returns the jump point found, or -1 if the jump runs into a wall
+   int jumpHorizontal(int index, int move);
+
+   // Jump up (move -stride) or down (move stride), starting at index
+   //    Returns the jump point found, or -1 if the jump runs into a wall
+   int jumpVertical(int index, int move);
+
+   // Jump from the jump point at index in the given LRUD direction, and add the jump point found to the open list
+   void jumpFrom(int index, int cost, int direction);
+
+   // Manhattan distance between two maze indexes
+   int manhattan(int a, int b);
+
+   // Order of the heap, the same as AStarSearch
+   static bool openAfter(const OpenNode& a, const OpenNode& b);
+};
+
+#endif // COSC_ASS_ONE_JUMP_POINT_SEARCH
@@ -0,0 +1,261 @@
+#include "LandmarkIndex.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// Stored for a cell a landmark does not reach, the biggest 16 or 32 bit number
+#define SHORT_UNREACHED 0xFFFF
+#define LONG_UNREACHED  0xFFFFFFFF
+
+// FNV-1a hash constants
+#define HASH_OFFSET 14695981039346656037ULL
+#define HASH_PRIME  1099511628211ULL
+
+LandmarkIndex::LandmarkIndex(Maze* maze, int numLandmarks) {
+   numLandmarks = std::max(1, std::min(numLandmarks, LANDMARK_MAX_COUNT));
+   int rows = maze->getRows();
+   int cols = maze->getCols();
+   numCells = (long) rows * cols;
+
+   // Every open cell that is not a landmark yet is at least 1 from the landmarks,
+   // so landmarks are picked until there are enough or every open cell is one
+   long openCells = 0;
+   for(int i = 0; i < maze->size(); ++i) {
+      if(maze->isOpen(i)) {
+         openCells++;
+      }
+   }
+   int count = std::min((long) numLandmarks, openCells);
+
+   // The distances are written straight into the index as 32 bit numbers, by cell,
+   // and narrowed to 16 bits in place once every distance is known
+   // A maze with no open cells still gets an index, with no landmarks
+   dataBytes = sizeof(Header) + (size_t) numCells * count * sizeof(uint32_t);
+   data = (unsigned char*) std::malloc(dataBytes);
+   if(data == nullptr) {
+      throw std::bad_alloc();
+   }
+   mapped = false;
+   setPointers();
+   std::memset(header, 0, sizeof(Header));
+   std::memset(longDistances, 0xFF, dataBytes - sizeof(Header));
+
+   // Distance from the nearest landmark picked so far, INT_MAX for an open cell no landmark reaches
+   // The next landmark is the open cell with the biggest one, so a part of the maze
+   // that no landmark reaches gets a landmark before any part gets a second one
+   std::vector<int> nearest(maze->size(), INT_MAX);
+   std::vector<int> queue;
+   int longest = 0;
+
+   for(int l = 0; l < count; ++l) {
+      int landmark = 0;
+      int furthest = 0;
+      for(int i = 0; i < maze->size(); ++i) {
+         if(maze->isOpen(i) && nearest[i] > furthest) {
+            landmark = i;
+            furthest = nearest[i];
+         }
+      }
+      header->landmarkX[l] = maze->getX(landmark);
+      header->landmarkY[l] = maze->getY(landmark);
+
+      // Landmark l's distance of the cell at maze index i is at slot(i)
+      auto slot = [&](int i) {
+         return ((long) maze->getY(i) * cols + maze->getX(i)) * count + l;
+      };
+
+      queue.clear();
+      longDistances[slot(landmark)] = 0;
+      queue.push_back(landmark);
+      for(unsigned int checked = 0; checked < queue.size(); ++checked) {
+         int index = queue[checked];
+         uint32_t distance = longDistances[slot(index)] + 1;
+         for(int i = 0; i < LRUD; ++i) {
+            int next = index + maze->getMove(i);
+            if(maze->isOpen(next) && longDistances[slot(next)] == LONG_UNREACHED) {
+               longDistances[slot(next)] = distance;
+               queue.push_back(next);
+            }
+         }
+      }
+
+      for(int index : queue) {
+         int distance = longDistances[slot(index)];
+         nearest[index] = std::min(nearest[index], distance);
+         longest = std::max(longest, distance);
+      }
+   }
+
+   // Every distance fits in 16 bits, so each one is moved down to its 16 bit slot
+   // The 16 bit slot of a cell is never after its 32 bit one, so going forwards nothing is overwritten before it is read
+   int distanceBytes = sizeof(uint32_t);
+   if(longest < SHORT_UNREACHED) {
+      distanceBytes = sizeof(uint16_t);
+      size_t numDistances = (size_t) numCells * count;
+      for(size_t i = 0; i < numDistances; ++i) {
+         uint32_t distance = longDistances[i];
+         shortDistances[i] = distance == LONG_UNREACHED ? SHORT_UNREACHED : distance;
+      }
+      dataBytes = sizeof(Header) + numDistances * distanceBytes;
+      data = (unsigned char*) std::realloc(data, dataBytes);
+      setPointers();
+   }
+
+   std::memcpy(header->magic, LANDMARK_MAGIC, sizeof(header->magic));
+   header->rows = rows;
+   header->cols = cols;
+   header->numLandmarks = count;
+   header->distanceBytes = distanceBytes;
+   header->mazeHash = hashMaze(maze);
+}
+
+LandmarkIndex::LandmarkIndex(std::string filename) {
+   data = nullptr;
+   dataBytes = 0;
+   mapped = true;
+
+   int fd = open(filename.c_str(), O_RDONLY);
+   if(fd < 0) {
+      throw std::runtime_error("Could not open file '" + filename + "'");
+   }
+
+   struct stat info;
+   if(fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(Header)) {
+      close(fd);
+      throw std::runtime_error("Not a landmark index '" + filename + "'");
+   }
+   dataBytes = info.st_size;
+
+   void* mappedData = mmap(nullptr, dataBytes, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+   if(mappedData == MAP_FAILED) {
+      throw std::runtime_error("Could not map file '" + filename + "'");
+   }
+   data = (unsigned char*) mappedData;
+   setPointers();
+   numCells = (long) header->rows * header->cols;
+
+   // Only the header is checked, the distances are read from the file as they are used
+   bool valid = std::memcmp(header->magic, LANDMARK_MAGIC, sizeof(header->magic)) == 0 &&
+                header->rows >= 0 && header->cols >= 0 &&
+                header->numLandmarks >= 0 && header->numLandmarks <= LANDMARK_MAX_COUNT &&
+                (header->distanceBytes == sizeof(uint16_t) || header->distanceBytes == sizeof(uint32_t)) &&
+                dataBytes == sizeof(Header) + (size_t) numCells * header->numLandmarks * header->distanceBytes;
+   if(!valid) {
+      munmap(data, dataBytes);
+      throw std::runtime_error("Not a landmark index '" + filename + "'");
+   }
+}
+
+LandmarkIndex::~LandmarkIndex() {
+   if(mapped) {
+      munmap(data, dataBytes);
+   } else {
+      std::free(data);
+   }
+   data = nullptr;
+   header = nullptr;
+}
+
+void LandmarkIndex::setPointers() {
+   header = (Header*) data;
+   shortDistances = (uint16_t*) (data + sizeof(Header));
+   longDistances = (uint32_t*) (data + sizeof(Header));
+}
+
+void LandmarkIndex::save(std::string filename) {
+   std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+   file.write((const char*) data, dataBytes);
+   file.close();
+   if(!file) {
+      throw std::runtime_error("Could not write file '" + filename + "'");
+   }
+}
+
+uint64_t LandmarkIndex::hashMaze(Maze* maze) {
+   uint64_t hash = HASH_OFFSET;
+
+   // The open cells of each row are packed into 64 bit words, and each word is hashed
+   for(int y = 0; y < maze->getRows(); ++y) {
+      uint64_t word = 0;
+      for(int x = 0; x < maze->getCols(); ++x) {
+         word = (word << 1) | (maze->isOpen(maze->index(x, y)) ? 1 : 0);
+         if(x % 64 == 63 || x == maze->getCols() - 1) {
+            hash = (hash ^ word) * HASH_PRIME;
+            word = 0;
+         }
+      }
+   }
+
+   return hash;
+}
+
+bool LandmarkIndex::matches(Maze* maze) {
+   return maze->getRows() == header->rows && maze->getCols() == header->cols &&
+          hashMaze(maze) == header->mazeHash;
+}
+
+int LandmarkIndex::distanceAt(int i, long cell) {
+   int distance = -1;
+   long at = cell * header->numLandmarks + i;
+
+   if(header->distanceBytes == sizeof(uint16_t)) {
+      if(shortDistances[at] != SHORT_UNREACHED) {
+         distance = shortDistances[at];
+      }
+   } else if(longDistances[at] != LONG_UNREACHED) {
+      distance = longDistances[at];
+   }
+
+   return distance;
+}
+
+int LandmarkIndex::lowerBound(int fromX, int fromY, int toX, int toY) {
+   long from = (long) fromY * header->cols + fromX;
+   long to = (long) toY * header->cols + toX;
+   int bound = 0;
+
+   for(int i = 0; i < header->numLandmarks && bound != LANDMARK_UNREACHABLE; ++i) {
+      int fromDistance = distanceAt(i, from);
+      int toDistance = distanceAt(i, to);
+
+      // A landmark that reaches only one of them shows they are not connected
+      if((fromDistance < 0) != (toDistance < 0)) {
+         bound = LANDMARK_UNREACHABLE;
+      } else if(fromDistance >= 0) {
+         bound = std::max(bound, std::abs(fromDistance - toDistance));
+      }
+   }
+
+   return bound;
+}
+
+int LandmarkIndex::getDistance(int i, int x, int y) {
+   return distanceAt(i, (long) y * header->cols + x);
+}
+
+int LandmarkIndex::getLandmarkX(int i) {
+   return header->landmarkX[i];
+}
+
+int LandmarkIndex::getLandmarkY(int i) {
+   return header->landmarkY[i];
+}
+
+int LandmarkIndex::getNumLandmarks() {
+   return header->numLandmarks;
+}
+
+long LandmarkIndex::bytes() {
+   return dataBytes - sizeof(Header);
+}
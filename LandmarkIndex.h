@@ -0,0 +1,116 @@
+#ifndef COSC_ASS_ONE_LANDMARK_INDEX
+#define COSC_ASS_ONE_LANDMARK_INDEX
+
+#include "Maze.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Default number of landmarks
+#define LANDMARK_COUNT 16
+
+// Most landmarks an index can have
+#define LANDMARK_MAX_COUNT 64
+
+// Returned by lowerBound when the two cells cannot reach each other
+#define LANDMARK_UNREACHABLE -1
+
+// The first bytes of a landmark index file
+#define LANDMARK_MAGIC "MAZELMK1"
+
+// Distances from a few landmark cells to every cell of a maze, for the ALT heuristic
+//    (A*, Landmarks and the Triangle inequality).
+//    For any landmark L, a path from a to b is at least |d(L,a) - d(L,b)| long,
+//    so the biggest of these over all landmarks is a lower bound on the distance
+//    from a to b that is usually much closer than the Manhattan distance.
+//    The landmarks are picked one at a time, each as far as it can be from the ones already picked,
+//    so they end up around the edges of the maze, and one in every part of it that cannot reach the others.
+//    The distances of a cell to all landmarks are next to each other, as 16 bit numbers
+//    if every distance fits, 32 bit otherwise.
+//    An index can be saved to a file and mapped back into memory, so it is only built once.
+class LandmarkIndex {
+public:
+
+   // Pick numLandmarks landmarks in the maze and flood from each of them
+   //    The maze is only read while the index is built
+   LandmarkIndex(Maze* maze, int numLandmarks);
+
+   // Map an index saved by save() into memory, without reading it
+   //    Throws std::runtime_error if the file cannot be opened or is not a landmark index
+   LandmarkIndex(std::string filename);
+
+   // Clean-up, unmaps the file
+   ~LandmarkIndex();
+
+   // Save the index to a file
+   //    Throws std::runtime_error if the file cannot be written
+   void save(std::string filename);
+
+   // Checks if the index was built for this maze, with the same cells open
+   //    Reads every cell of the maze once, which is much quicker than building the index again
+   bool matches(Maze* maze);
+
+   // A lower bound on the number of moves from (fromX,fromY) to (toX,toY)
+   //    Returns LANDMARK_UNREACHABLE if a landmark reaches one of them but not the other
+   int lowerBound(int fromX, int fromY, int toX, int toY);
+
+   // Distance from landmark i to (x,y), or -1 if it cannot be reached
+   int getDistance(int i, int x, int y);
+
+   // The position of landmark i
+   int getLandmarkX(int i);
+   int getLandmarkY(int i);
+
+   // Number of landmarks
+   int getNumLandmarks();
+
+   // Number of bytes taken by the distances
+   long bytes();
+
+   LandmarkIndex(LandmarkIndex& other) = delete;
+   LandmarkIndex& operator=(LandmarkIndex& other) = delete;
+
+private:
+
+   // The start of an index file, followed by the landmark positions and then the distances
+   struct Header {
+      char magic[8];
+      int32_t rows;
+      int32_t cols;
+      int32_t numLandmarks;
+      int32_t distanceBytes;
+      uint64_t mazeHash;
+      int32_t landmarkX[LANDMARK_MAX_COUNT];
+      int32_t landmarkY[LANDMARK_MAX_COUNT];
+   };
+
+   // The header, then the distances of cell y * cols + x at (y * cols + x) * numLandmarks
+   // Either made by the build constructor or mapped from a file
+   unsigned char* data;
+   size_t dataBytes;
+
+   // Checks if data is a mapped file, rather than allocated
+   bool mapped;
+
+   // The header at the start of data
+   Header* header;
+
+   // The distances after the header, 16 or 32 bit
+   uint16_t* shortDistances;
+   uint32_t* longDistances;
+
+   // Number of cells in the maze the index was built for
+   long numCells;
+
+   // A hash of which cells of the maze are open, to check the index is used on the same maze
+   static uint64_t hashMaze(Maze* maze);
+
+   // The distance from landmark i to the cell y * cols + x, or -1
+   int distanceAt(int i, long cell);
+
+   // Point header and the distances into data
+   void setPointers();
+};
+
+#endif // COSC_ASS_ONE_LANDMARK_INDEX
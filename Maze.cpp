@@ -0,0 +1,252 @@
+#include "Maze.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Number of characters compared at once by packRow
+#define MAZE_PACK_CHARS 16
+
+// Set the bits of a mask of up to MAZE_PACK_CHARS cells, the first one at the given bit
+static void orMask(uint64_t* bits, uint64_t mask, int bit) {
+
+   // The bits may start part way through a word and carry on into the next one
+   int shift = bit % MAZE_WORD_BITS;
+   bits[bit / MAZE_WORD_BITS] |= mask << shift;
+   if(shift > MAZE_WORD_BITS - MAZE_PACK_CHARS) {
+      bits[bit / MAZE_WORD_BITS + 1] |= mask >> (MAZE_WORD_BITS - shift);
+   }
+}
+
+Maze::Maze(Grid grid, int rows, int cols) {
+   init(rows, cols, cols + 2);
+   openBits = allocateBits();
+   ownsBits = true;
+   firstRow = nullptr;
+
+   // Only the open cells are set, so the border is a wall without being stored
+   for(int y = 0; y < rows; ++y) {
+      packRow(grid[y], cols, index(0, y), true);
+   }
+}
+
+Maze::Maze(char* firstRow, int rows, int cols, int stride) {
+   init(rows, cols, stride);
+   openBits = allocateBits();
+   ownsBits = true;
+   this->firstRow = firstRow;
+
+   // The characters past the end of each row are not packed, so they act as the border
+   for(int y = 0; y < rows; ++y) {
+      packRow(firstRow + (long) y * stride, cols, index(0, y), false);
+   }
+}
+
+Maze::Maze(uint64_t* openBits, int rows, int cols) {
+   init(rows, cols, cols + 2);
+   this->openBits = openBits;
+   ownsBits = false;
+   firstRow = nullptr;
+}
+
+void Maze::init(int rows, int cols, int stride) {
+
+   this->rows = rows;
+   this->cols = cols;
+   this->stride = stride;
+   this->numCells = (rows + 2) * stride;
+
+   moves[0] = -1;
+   moves[1] = 1;
+   moves[2] = -stride;
+   moves[3] = stride;
+
+   numWords = numCells / MAZE_WORD_BITS + 2;
+
+   // No wall characters are kept until packRow finds one
+   for(int p = 0; p < MAZE_CLASS_PLANES; ++p) {
+      classBits[p] = nullptr;
+   }
+   palette[0] = MAZE_BORDER;
+   paletteSize = 1;
+}
+
+uint64_t* Maze::allocateBits() {
+
+   // aligned_alloc needs the size to be a multiple of the alignment
+   size_t bytes = ((size_t) numWords * sizeof(uint64_t) + MAZE_ALIGNMENT - 1)
+                  / MAZE_ALIGNMENT * MAZE_ALIGNMENT;
+   uint64_t* bits = (uint64_t*) std::aligned_alloc(MAZE_ALIGNMENT, bytes);
+   if(bits == nullptr) {
+      throw std::bad_alloc();
+   }
+   std::memset(bits, 0, bytes);
+
+   return bits;
+}
+
+Maze::~Maze() {
+   if(ownsBits) {
+      std::free(openBits);
+   }
+   openBits = nullptr;
+   for(int p = 0; p < MAZE_CLASS_PLANES; ++p) {
+      std::free(classBits[p]);
+      classBits[p] = nullptr;
+   }
+   firstRow = nullptr;
+}
+
+void Maze::packRow(const char* row, int count, int firstIndex, bool keepOthers) {
+   int x = 0;
+
+#ifdef __SSE2__
+   // Compare 16 characters at once, each comparison gives one bit of the mask
+   const __m128i open = _mm_set1_epi8(MAZE_OPEN);
+   const __m128i border = _mm_set1_epi8(MAZE_BORDER);
+   for(; x + MAZE_PACK_CHARS <= count; x += MAZE_PACK_CHARS) {
+      __m128i chars = _mm_loadu_si128((const __m128i*) (row + x));
+      unsigned int openMask = _mm_movemask_epi8(_mm_cmpeq_epi8(chars, open));
+      orMask(openBits, openMask, firstIndex + x);
+
+      if(keepOthers) {
+         unsigned int borderMask = _mm_movemask_epi8(_mm_cmpeq_epi8(chars, border));
+         unsigned int otherMask = ~(openMask | borderMask) & 0xFFFF;
+
+         // Most mazes draw their walls with one character, class 1, so those are set 16 at a time
+         if(otherMask != 0 && paletteSize > 1) {
+            unsigned int firstMask = _mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8(palette[1])));
+            orMask(classBits[0], firstMask, firstIndex + x);
+            otherMask &= ~firstMask;
+         }
+
+         // Only look at the characters one by one if one of them is something else
+         for(int i = 0; otherMask != 0; ++i, otherMask >>= 1) {
+            if(otherMask & 1) {
+               keepCell(firstIndex + x + i, row[x + i]);
+            }
+         }
+      }
+   }
+#endif
+
+   for(; x < count; ++x) {
+      int bit = firstIndex + x;
+      if(row[x] == MAZE_OPEN) {
+         openBits[bit / MAZE_WORD_BITS] |= (uint64_t) 1 << (bit % MAZE_WORD_BITS);
+      } else if(keepOthers && row[x] != MAZE_BORDER) {
+         keepCell(bit, row[x]);
+      }
+   }
+}
+
+int Maze::wallClass(char cell) {
+   int found = 0;
+
+   for(int c = 1; found == 0 && c < paletteSize; ++c) {
+      if(palette[c] == cell) {
+         found = c;
+      }
+   }
+
+   // A new character gets the next class, and the planes its bits need
+   if(found == 0 && cell != MAZE_BORDER && paletteSize < MAZE_CLASSES) {
+      found = paletteSize;
+      palette[paletteSize] = cell;
+      paletteSize++;
+      for(int p = 0; p < MAZE_CLASS_PLANES; ++p) {
+         if(((found >> p) & 1) && classBits[p] == nullptr) {
+            classBits[p] = allocateBits();
+         }
+      }
+   }
+
+   return found;
+}
+
+int Maze::getClass(int index) const {
+   int found = 0;
+
+   for(int p = 0; p < MAZE_CLASS_PLANES; ++p) {
+      if(classBits[p] != nullptr && ((classBits[p][index / MAZE_WORD_BITS] >> (index % MAZE_WORD_BITS)) & 1)) {
+         found |= 1 << p;
+      }
+   }
+
+   return found;
+}
+
+void Maze::keepCell(int index, char cell) {
+   int found = wallClass(cell);
+   uint64_t bit = (uint64_t) 1 << (index % MAZE_WORD_BITS);
+
+   for(int p = 0; p < MAZE_CLASS_PLANES; ++p) {
+      if(classBits[p] != nullptr) {
+         if((found >> p) & 1) {
+            classBits[p][index / MAZE_WORD_BITS] |= bit;
+         } else {
+            classBits[p][index / MAZE_WORD_BITS] &= ~bit;
+         }
+      }
+   }
+
+   // Only a character that did not fit in the palette goes on the side
+   if(!otherCells.empty()) {
+      otherCells.erase(index);
+   }
+   if(found == 0 && cell != MAZE_BORDER) {
+      otherCells[index] = cell;
+   }
+}
+
+char Maze::getCell(int x, int y) const {
+   int i = index(x, y);
+   char cell = MAZE_BORDER;
+
+   if(isOpen(i)) {
+      cell = MAZE_OPEN;
+   } else if(firstRow != nullptr) {
+      cell = firstRow[(long) y * stride + x];
+   } else if(getClass(i) != 0) {
+      cell = palette[getClass(i)];
+   } else if(!otherCells.empty()) {
+      auto other = otherCells.find(i);
+      if(other != otherCells.end()) {
+         cell = other->second;
+      }
+   }
+
+   return cell;
+}
+
+void Maze::setCell(int x, int y, char cell) {
+   int i = index(x, y);
+   uint64_t bit = (uint64_t) 1 << (i % MAZE_WORD_BITS);
+
+   if(cell == MAZE_OPEN) {
+      openBits[i / MAZE_WORD_BITS] |= bit;
+   } else {
+      openBits[i / MAZE_WORD_BITS] &= ~bit;
+   }
+
+   // Keep the character where getCell will find it
+   if(firstRow != nullptr) {
+      firstRow[(long) y * stride + x] = cell;
+   } else if(cell == MAZE_OPEN) {
+      keepCell(i, MAZE_BORDER);
+   } else {
+      keepCell(i, cell);
+   }
+}
+
+long Maze::bytes() const {
+   return (long) numWords * sizeof(uint64_t);
+}
+
+long Maze::packedBytes(int rows, int cols) {
+   return ((long) (rows + 2) * (cols + 2) / MAZE_WORD_BITS + 2) * sizeof(uint64_t);
+}
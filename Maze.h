@@ -0,0 +1,180 @@
+#ifndef COSC_ASS_ONE_MAZE
+#define COSC_ASS_ONE_MAZE
+
+#include "Types.h"
+
+#include <cstdint>
+#include <unordered_map>
+
+// Character used for the wall border that is added around the maze
+#define MAZE_BORDER '='
+
+// Character of a cell the robot can move onto
+#define MAZE_OPEN '.'
+
+// The bitmap starts on a cache line boundary
+#define MAZE_ALIGNMENT 64
+
+// Number of cells in one word of the bitmap
+#define MAZE_WORD_BITS 64
+
+// Number of bitplanes that give the character of a wall cell of a maze copied from a Grid
+//    A maze keeps up to (1 << MAZE_CLASS_PLANES) - 1 wall characters besides MAZE_BORDER in them
+#define MAZE_CLASS_PLANES 2
+#define MAZE_CLASSES (1 << MAZE_CLASS_PLANES)
+
+// Number of moves the robot can make {Left, Right, Up, Down}
+#define LRUD 4
+
+// A maze stored as one row-major bitmap, one bit per cell that is set if the robot can move onto it.
+//    The searches only ever ask if a cell is open, so the bitmap is all they
+//    read, and it is 8 times smaller than a character per cell.
+//    The maze is surrounded by a one cell wall border, so every cell of the
+//    original maze has four neighbours inside the bitmap and a search never
+//    has to check if a neighbour is out of bounds.
+//    Cells are addressed by an index, the neighbours of index i are
+//    i - 1, i + 1, i - stride and i + stride.
+//    The characters themselves are only kept where they can be got back:
+//    a maze copied from a Grid gives every wall cell a class, an index into a small
+//    palette of wall characters, stored as bitplanes the size of the bitmap. A plane is
+//    only allocated once a character needs it, so a maze drawn with '=' keeps
+//    nothing more, and one drawn with '~' keeps one more bit per cell.
+//    A maze viewed in memory reads the characters from there.
+//    A maze can also use a bitmap that is already packed, for example mapped from a
+//    binary maze file (see BinaryMazeFile.h). It then only knows which cells are open.
+class Maze {
+public:
+
+   // Pack a Grid (grid[y][x]) of the given size into a new bordered bitmap
+   Maze(Grid grid, int rows, int cols);
+
+   // Pack rows that are already in memory, stride characters apart, without copying the characters
+   //    The maze does not own the memory. getCell reads the characters from it,
+   //    and setCell writes to it. Row y starts at firstRow + y * stride.
+   //    The stride must be more than cols (a line ending works, see MazeFile.h).
+   Maze(char* firstRow, int rows, int cols, int stride);
+
+   // Use a bitmap that is already packed the way a maze copied from a Grid packs it, without copying it
+   //    The maze does not own the bitmap, which must be packedBytes(rows, cols) long,
+   //    and setCell writes to it. getCell only gives MAZE_OPEN or MAZE_BORDER.
+   Maze(uint64_t* openBits, int rows, int cols);
+
+   // Clean-up
+   ~Maze();
+
+   // Number of rows in the original maze
+   int getRows() const { return rows; }
+
+   // Number of columns in the original maze
+   int getCols() const { return cols; }
+
+   // Distance between the index of a cell and the cell below it
+   int getStride() const { return stride; }
+
+   // Number of indexes in the buffer, including the border
+   int size() const { return numCells; }
+
+   // Index of the cell at (x,y) of the original maze
+   int index(int x, int y) const { return (y + 1) * stride + (x + 1); }
+
+   // x-co-ordinate of the cell at the given index
+   int getX(int index) const { return index % stride - 1; }
+
+   // y-co-ordinate of the cell at the given index
+   int getY(int index) const { return index / stride - 1; }
+
+   // Checks if the robot can move onto the cell at the given index
+   bool isOpen(int index) const {
+      return (openBits[index / MAZE_WORD_BITS] >> (index % MAZE_WORD_BITS)) & 1;
+   }
+
+   // The character at (x,y) of the original maze
+   char getCell(int x, int y) const;
+
+   // Change the character at (x,y) of the original maze
+   void setCell(int x, int y, char cell);
+
+   // Number of bytes used by the bitmap
+   long bytes() const;
+
+   // The bitmap, bytes() long
+   const uint64_t* getBits() const { return openBits; }
+
+   // Number of bytes of the bitmap of a maze of the given size copied from a Grid
+   static long packedBytes(int rows, int cols);
+
+   // Index offset of a move, the moves are {Left, Right, Up, Down}
+   int getMove(int direction) const { return moves[direction]; }
+
+private:
+
+   // The bordered bitmap, (rows + 2) x stride bits, bit i is set if index i is open
+   uint64_t* openBits;
+
+   // Checks if the bitmap was allocated by the maze, and has to be freed
+   bool ownsBits;
+
+   // Number of words in the bitmap (one more than needed, so a row can be packed a word at a time)
+   int numWords;
+
+   // The first row of a maze viewed in memory, (x,y) is firstRow[y * stride + x]
+   // nullptr for a maze copied from a Grid
+   char* firstRow;
+
+   // The class of every wall cell of a maze copied from a Grid, bit p of the class is in classBits[p]
+   // A plane is nullptr until a class needs it
+   uint64_t* classBits[MAZE_CLASS_PLANES];
+
+   // The wall character of each class, class 0 is MAZE_BORDER
+   char palette[MAZE_CLASSES];
+
+   // Number of classes in the palette
+   int paletteSize;
+
+   // The wall characters that did not fit in the palette, by index
+   // Empty unless the maze uses more than MAZE_CLASSES - 1 other wall characters
+   std::unordered_map<int, char> otherCells;
+
+   // Number of rows in the original maze
+   int rows;
+
+   // Number of columns in the original maze
+   int cols;
+
+   // Length of one row of the buffer, cols plus the left and right border
+   // (or the line ending, for a maze viewed straight from a file)
+   int stride;
+
+   // Number of cells in the bitmap, including the border
+   int numCells;
+
+   // Index offsets of the moves {Left, Right, Up, Down}
+   int moves[LRUD];
+
+   // Set up the size and moves
+   void init(int rows, int cols, int stride);
+
+   // Allocate an empty bitmap or bitplane of numWords words
+   uint64_t* allocateBits();
+
+   // Set the bits of count characters of a row, the first one at the given index
+   //    The class of the wall characters that are not MAZE_BORDER is kept if keepOthers is true
+   void packRow(const char* row, int count, int firstIndex, bool keepOthers);
+
+   // Class of a wall character, added to the palette if there is room
+   //    0 if the character is MAZE_BORDER or did not fit in the palette
+   int wallClass(char cell);
+
+   // Class of the cell at the given index
+   int getClass(int index) const;
+
+   // Keep the wall character of the cell at the given index
+   void keepCell(int index, char cell);
+
+public:
+   // The bitmap may be owned by the maze, so it cannot be copied
+   Maze(Maze& other) = delete;
+   Maze& operator=(Maze& other) = delete;
+};
+
+#endif // COSC_ASS_ONE_MAZE
@@ -0,0 +1,94 @@
+#include "MazeFile.h"
+
+#include <climits>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MazeFile::MazeFile(std::string filename) {
+   region = nullptr;
+   regionBytes = 0;
+   maze = nullptr;
+
+   int fd = open(filename.c_str(), O_RDONLY);
+   if(fd < 0) {
+      throw std::runtime_error("Could not open file '" + filename + "'");
+   }
+
+   struct stat info;
+   if(fstat(fd, &info) != 0 || info.st_size == 0) {
+      close(fd);
+      throw std::runtime_error("No Maze in file");
+   }
+   size_t fileBytes = info.st_size;
+
+   // Writes only go to a private copy of the page, so the file is never changed
+   void* mapped = mmap(nullptr, fileBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if(mapped == MAP_FAILED) {
+      throw std::runtime_error("Could not map file '" + filename + "'");
+   }
+   region = (char*) mapped;
+   regionBytes = fileBytes;
+   char* text = region;
+
+   // Line endings at the end of the file do not count as rows
+   size_t textBytes = fileBytes;
+   while(textBytes > 0 && (text[textBytes - 1] == '\n' || text[textBytes - 1] == '\r')) {
+      textBytes--;
+   }
+
+   // The first line gives the width of every row, and the length of a line ending
+   size_t cols = 0;
+   while(cols < textBytes && text[cols] != '\n' && text[cols] != '\r') {
+      cols++;
+   }
+   size_t stride = cols;
+   while(stride < fileBytes && text[stride] == '\r') {
+      stride++;
+   }
+   stride++;
+
+   // Every row is stride apart and ends with the same line ending, except the last one
+   bool consistent = cols > 0 && (textBytes + stride - cols) % stride == 0;
+   size_t rows = consistent ? (textBytes + stride - cols) / stride : 0;
+
+   // Maze indexes its cells with ints, border included, so a bigger maze cannot be planned on
+   // This is checked before the rows are read, so a file that is too big is not read at all
+   if(consistent && (rows + 2) * stride > INT_MAX) {
+      munmap(region, regionBytes);
+      throw std::runtime_error("Maze too large");
+   }
+   for(size_t y = 0; consistent && y + 1 < rows; ++y) {
+      consistent = text[y * stride + stride - 1] == '\n' &&
+                   (text[y * stride + cols] == '\n' || text[y * stride + cols] == '\r');
+   }
+   if(!consistent) {
+      munmap(region, regionBytes);
+      throw std::runtime_error(cols == 0 ? "No Maze in file" : "Maze dimensions not consistent");
+   }
+
+   maze = new Maze(text, (int) rows, (int) cols, (int) stride);
+}
+
+MazeFile::~MazeFile() {
+   delete maze;
+   maze = nullptr;
+
+   munmap(region, regionBytes);
+   region = nullptr;
+}
+
+Maze* MazeFile::getMaze() {
+   return maze;
+}
+
+int MazeFile::getRows() {
+   return maze->getRows();
+}
+
+int MazeFile::getCols() {
+   return maze->getCols();
+}
@@ -0,0 +1,52 @@
+#ifndef COSC_ASS_ONE_MAZE_FILE
+#define COSC_ASS_ONE_MAZE_FILE
+
+#include "Maze.h"
+
+#include <cstddef>
+#include <string>
+
+// A maze file mapped into memory, read straight from the page cache without copying.
+//    The file is one row of the maze per line, every line the same length.
+//    The Maze it hands out points at the mapped rows, with the line ending
+//    counted in the stride. It packs the rows into its bitmap once, and
+//    getCell reads the characters back from the mapping.
+//    The mapping is private: Maze::setCell changes a copy of the page it is on,
+//    never the file.
+class MazeFile {
+public:
+
+   // Map the given maze file
+   //    Throws std::runtime_error if it cannot be opened or mapped, if it is empty,
+   //    if the lines are not all the same length, or if the maze with its border
+   //    has more than INT_MAX cells (Maze indexes its cells with ints)
+   MazeFile(std::string filename);
+
+   // Unmap the file
+   //    The Maze from getMaze() is deleted, so no PathPlanning may still be using it
+   ~MazeFile();
+
+   // The maze, owned by the file
+   //    Pass it to PathPlanning(Maze*) to plan on the file without copying it
+   Maze* getMaze();
+
+   // Number of rows in the maze
+   int getRows();
+
+   // Number of columns in the maze
+   int getCols();
+
+   MazeFile(MazeFile& other) = delete;
+   MazeFile& operator=(MazeFile& other) = delete;
+
+private:
+
+   // The mapped file
+   char* region;
+   size_t regionBytes;
+
+   // The view of the mapped rows
+   Maze* maze;
+};
+
+#endif // COSC_ASS_ONE_MAZE_FILE
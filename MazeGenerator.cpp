@@ -0,0 +1,180 @@
+#include "MazeGenerator.h"
+
+#include <vector>
+
+// Number of random cells tried by randomOpenCell before it gives up
+#define OPEN_CELL_TRIES 100000
+
+MazeGenerator::MazeGenerator(unsigned int seed) :
+   random(seed)
+{}
+
+int MazeGenerator::randomBelow(int limit) {
+   return (int) (random() % (unsigned int) limit);
+}
+
+Grid MazeGenerator::makeGrid(int rows, int cols, char fill) {
+   Grid grid = new char*[rows];
+   for(int y = 0; y < rows; ++y) {
+      grid[y] = new char[cols];
+      for(int x = 0; x < cols; ++x) {
+         grid[y][x] = fill;
+      }
+   }
+   return grid;
+}
+
+Grid MazeGenerator::openRoom(int rows, int cols, int obstaclePercent) {
+   Grid grid = makeGrid(rows, cols, '.');
+
+   for(int y = 0; y < rows; ++y) {
+      for(int x = 0; x < cols; ++x) {
+         bool border = x == 0 || y == 0 || x == cols - 1 || y == rows - 1;
+         if(border || randomBelow(100) < obstaclePercent) {
+            grid[y][x] = '=';
+         }
+      }
+   }
+
+   return grid;
+}
+
+Grid MazeGenerator::perfectMaze(int rows, int cols) {
+   Grid grid = makeGrid(rows, cols, '=');
+
+   // Cells of the maze are at odd co-ordinates, the cells between them are walls that can be knocked down
+   int cellRows = (rows - 1) / 2;
+   int cellCols = (cols - 1) / 2;
+   if(cellRows > 0 && cellCols > 0) {
+
+      // {Left, Right, Up, Down} in maze cells
+      int moveHorizontal[4] = {-1, 1, 0, 0};
+      int moveVertical[4] = {0, 0, -1, 1};
+
+      // Depth-first search with an explicit stack, so large mazes do not overflow the call stack
+      std::vector<int> stack;
+      stack.push_back(0);
+      grid[1][1] = '.';
+
+      while(!stack.empty()) {
+         int cell = stack.back();
+         int cx = cell % cellCols;
+         int cy = cell / cellCols;
+
+         // Collect the neighbours that have not been carved yet
+         int options[4];
+         int numOptions = 0;
+         for(int i = 0; i < 4; ++i) {
+            int nx = cx + moveHorizontal[i];
+            int ny = cy + moveVertical[i];
+            if(nx >= 0 && nx < cellCols && ny >= 0 && ny < cellRows &&
+               grid[ny * 2 + 1][nx * 2 + 1] == '=') {
+               options[numOptions] = i;
+               numOptions++;
+            }
+         }
+
+         if(numOptions == 0) {
+            stack.pop_back();
+         }
+         else {
+            int i = options[randomBelow(numOptions)];
+            int nx = cx + moveHorizontal[i];
+            int ny = cy + moveVertical[i];
+            grid[cy * 2 + 1 + moveVertical[i]][cx * 2 + 1 + moveHorizontal[i]] = '.';
+            grid[ny * 2 + 1][nx * 2 + 1] = '.';
+            stack.push_back(ny * cellCols + nx);
+         }
+      }
+   }
+
+   return grid;
+}
+
+Grid MazeGenerator::spiral(int rows, int cols) {
+   Grid grid = makeGrid(rows, cols, '=');
+
+   // {Right, Down, Left, Up}, turning clockwise
+   int moveHorizontal[4] = {1, 0, -1, 0};
+   int moveVertical[4] = {0, 1, 0, -1};
+
+   if(rows > 2 && cols > 2) {
+      int x = 1;
+      int y = 1;
+      int direction = 0;
+      int turns = 0;
+      grid[y][x] = '.';
+
+      // Carve the next cell unless it is the border or the cell after it is already carved,
+      //    which leaves a wall one cell thick between the rings. Stop when turning does not help.
+      while(turns < 2) {
+         int nx = x + moveHorizontal[direction];
+         int ny = y + moveVertical[direction];
+         int afterX = nx + moveHorizontal[direction];
+         int afterY = ny + moveVertical[direction];
+         bool inside = nx > 0 && nx < cols - 1 && ny > 0 && ny < rows - 1;
+
+         if(inside && grid[ny][nx] == '=' && grid[afterY][afterX] == '=') {
+            grid[ny][nx] = '.';
+            x = nx;
+            y = ny;
+            turns = 0;
+         } else {
+            direction = (direction + 1) % 4;
+            turns++;
+         }
+      }
+   }
+
+   return grid;
+}
+
+Grid MazeGenerator::noiseMap(int rows, int cols, int blockedPercent) {
+   Grid grid = makeGrid(rows, cols, '=');
+
+   // One random value from 0 to 99 for every NOISE_LATTICE cells in each direction
+   int latticeCols = cols / NOISE_LATTICE + 2;
+   int latticeRows = rows / NOISE_LATTICE + 2;
+   std::vector<int> lattice((long) latticeRows * latticeCols);
+   for(int& value : lattice) {
+      value = randomBelow(100);
+   }
+
+   // Blend the four lattice values around each cell by how close the cell is to them
+   for(int y = 1; y < rows - 1; ++y) {
+      int ly = y / NOISE_LATTICE;
+      int fy = y % NOISE_LATTICE;
+      for(int x = 1; x < cols - 1; ++x) {
+         int lx = x / NOISE_LATTICE;
+         int fx = x % NOISE_LATTICE;
+         long top = (long) ly * latticeCols + lx;
+         long bottom = top + latticeCols;
+         int value = (lattice[top] * (NOISE_LATTICE - fx) + lattice[top + 1] * fx) * (NOISE_LATTICE - fy) +
+                     (lattice[bottom] * (NOISE_LATTICE - fx) + lattice[bottom + 1] * fx) * fy;
+         if(value >= blockedPercent * NOISE_LATTICE * NOISE_LATTICE) {
+            grid[y][x] = '.';
+         }
+      }
+   }
+
+   return grid;
+}
+
+bool MazeGenerator::randomOpenCell(Grid grid, int rows, int cols, int& x, int& y) {
+   bool found = false;
+
+   for(int i = 0; i < OPEN_CELL_TRIES && !found; ++i) {
+      x = randomBelow(cols);
+      y = randomBelow(rows);
+      found = grid[y][x] == '.';
+   }
+
+   return found;
+}
+
+void deleteGrid(Grid grid, int rows) {
+   for(int y = 0; y < rows; ++y) {
+      delete[] grid[y];
+   }
+   delete[] grid;
+}
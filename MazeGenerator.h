@@ -0,0 +1,56 @@
+#ifndef COSC_ASS_ONE_MAZE_GENERATOR
+#define COSC_ASS_ONE_MAZE_GENERATOR
+
+#include "Types.h"
+
+#include <random>
+
+// Distance in cells between the random values of noiseMap
+#define NOISE_LATTICE 8
+
+// Makes mazes for benchmarks, the same seed always makes the same mazes.
+//    Every maze is returned as a new Grid with a wall around the outside,
+//    ready to be passed to PathPlanning (which takes ownership of it).
+class MazeGenerator {
+public:
+
+   // Create a generator with the given seed
+   MazeGenerator(unsigned int seed);
+
+   // A room of '.' with about obstaclePercent percent of the cells turned into '='
+   Grid openRoom(int rows, int cols, int obstaclePercent);
+
+   // A perfect maze (exactly one path between any two cells) carved by a depth-first search
+   //    Mostly long one cell wide corridors
+   Grid perfectMaze(int rows, int cols);
+
+   // A single one cell wide corridor that spirals in from the top left corner to the middle
+   //    The path between its two ends is about half of the cells long
+   Grid spiral(int rows, int cols);
+
+   // A map of irregular blocked patches, like caves
+   //    Random values on a coarse lattice are blended over the cells between them,
+   //    and the cells whose value is below blockedPercent are turned into '='.
+   //    Above about 40 percent the open cells break up into separate regions.
+   Grid noiseMap(int rows, int cols, int blockedPercent);
+
+   // Pick a random '.' cell of the grid
+   //    Returns false if none was found after a number of tries
+   bool randomOpenCell(Grid grid, int rows, int cols, int& x, int& y);
+
+private:
+
+   // The random number generator
+   std::mt19937 random;
+
+   // A new rows x cols grid filled with the given character
+   Grid makeGrid(int rows, int cols, char fill);
+
+   // A random integer from 0 to limit - 1
+   int randomBelow(int limit);
+};
+
+// Delete a Grid made by MazeGenerator that was not passed to PathPlanning
+void deleteGrid(Grid grid, int rows);
+
+#endif // COSC_ASS_ONE_MAZE_GENERATOR
@@ -0,0 +1,69 @@
+#include "MultiSourceFlood.h"
+
+// Marks a cell that has not been reached, the same as PathPlanning's UNVISITED
+#define NOT_REACHED -1
+
+MultiSourceFlood::MultiSourceFlood(Maze* maze) {
+   this->maze = maze;
+
+   distances = new int[maze->size()];
+   owners = new int[maze->size()];
+   numSources = 0;
+}
+
+MultiSourceFlood::~MultiSourceFlood() {
+   delete[] distances;
+   distances = nullptr;
+   delete[] owners;
+   owners = nullptr;
+}
+
+std::vector<int>& MultiSourceFlood::getReached() {
+   return reached;
+}
+
+int MultiSourceFlood::getNumSources() {
+   return numSources;
+}
+
+void MultiSourceFlood::flood(PDList* sources) {
+
+   // Forget the last flood
+   for(int i = 0; i < maze->size(); ++i) {
+      distances[i] = NOT_REACHED;
+      owners[i] = NOT_REACHED;
+   }
+   reached.clear();
+   reached.reserve(maze->size());
+
+   // Every source is level 0 and owns itself
+   for(int i = 0; i < sources->size(); ++i) {
+      int x = sources->get(i)->getX();
+      int y = sources->get(i)->getY();
+
+      if(x >= 0 && x < maze->getCols() && y >= 0 && y < maze->getRows() &&
+         distances[maze->index(x, y)] == NOT_REACHED) {
+
+         int index = maze->index(x, y);
+         distances[index] = 0;
+         owners[index] = i;
+         reached.push_back(index);
+      }
+   }
+   numSources = reached.size();
+
+   // The queue is in order of distance, so the first source to reach a cell is its nearest
+   for(unsigned int head = 0; head < reached.size(); ++head) {
+      int index = reached[head];
+
+      for(int i = 0; i < LRUD; ++i) {
+         int next = index + maze->getMove(i);
+
+         if(distances[next] == NOT_REACHED && maze->isOpen(next)) {
+            distances[next] = distances[index] + 1;
+            owners[next] = owners[index];
+            reached.push_back(next);
+         }
+      }
+   }
+}
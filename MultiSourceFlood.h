@@ -0,0 +1,63 @@
+#ifndef COSC_ASS_ONE_MULTI_SOURCE_FLOOD
+#define COSC_ASS_ONE_MULTI_SOURCE_FLOOD
+
+#include "Maze.h"
+#include "PDList.h"
+
+#include <vector>
+
+// Breadth-first flood fill from several starts at once on a Maze.
+//    Every start is put in the queue at distance 0 before the flood begins,
+//    so one pass gives every cell its distance to the nearest start. Each
+//    cell also gets an owner, the start it was reached from, copied from the
+//    cell that reached it. This costs the same as flooding from one start.
+//    When two starts are equally near a cell, the owner is one of them.
+class MultiSourceFlood {
+public:
+
+   // Create a flood fill for the given maze, the maze is not owned by the flood fill
+   MultiSourceFlood(Maze* maze);
+
+   // Clean-up
+   ~MultiSourceFlood();
+
+   // Flood the maze from every position in sources
+   //    A source outside the maze, or at the same place as an earlier source, is skipped
+   void flood(PDList* sources);
+
+   // Distance to the nearest source of the cell at the given maze index, or -1 if it was not reached
+   int getDistance(int index) { return distances[index]; }
+
+   // Position in the sources list of the nearest source of the cell at the given maze index,
+   //    or -1 if it was not reached
+   int getOwner(int index) { return owners[index]; }
+
+   // Maze indexes of the cells reached by the last flood, in the order of their distance
+   //    The sources that were used come first
+   std::vector<int>& getReached();
+
+   // Number of sources that were used by the last flood
+   int getNumSources();
+
+   MultiSourceFlood(MultiSourceFlood& other) = delete;
+   MultiSourceFlood& operator=(MultiSourceFlood& other) = delete;
+
+private:
+
+   // The maze being flooded
+   Maze* maze;
+
+   // Distance of every cell to its nearest source, by maze index
+   int* distances;
+
+   // Nearest source of every cell, by maze index
+   int* owners;
+
+   // The queue of the flood, which is also every cell reached in order
+   std::vector<int> reached;
+
+   // Number of sources at the front of reached
+   int numSources;
+};
+
+#endif // COSC_ASS_ONE_MULTI_SOURCE_FLOOD
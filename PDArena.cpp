@@ -0,0 +1,69 @@
+#include "PDArena.h"
+
+#include <algorithm>
+#include <new>
+
+PDArena::PDArena(int firstSlab) {
+   this->firstSlab = firstSlab < 1 ? 1 : firstSlab;
+   currentSlab = -1;
+   used = 0;
+   numMade = 0;
+}
+
+PDArena::~PDArena() {
+
+   // A position has nothing to clean-up, so only the raw memory is freed
+   for(PositionDistance* slab : slabs) {
+      ::operator delete(slab);
+   }
+   slabs.clear();
+   slabSizes.clear();
+}
+
+PDPtr PDArena::make(int x, int y, int distance) {
+
+   // Move on to the next slab when this one is full, making it if it is not there yet
+   if(currentSlab < 0 || used == slabSizes[currentSlab]) {
+      currentSlab++;
+      used = 0;
+
+      if(currentSlab == (int) slabs.size()) {
+         // Double the last slab, unless it was already as big as PDARENA_MAX_SLAB
+         int slabSize = firstSlab;
+         if(currentSlab > 0) {
+            int last = slabSizes[currentSlab - 1];
+            slabSize = last >= PDARENA_MAX_SLAB ? last : std::min(last * 2, PDARENA_MAX_SLAB);
+         }
+
+         slabs.push_back(static_cast<PositionDistance*>(
+            ::operator new(sizeof(PositionDistance) * slabSize)));
+         slabSizes.push_back(slabSize);
+      }
+   }
+
+   // Build the position in the next free slot
+   PDPtr position = new (slabs[currentSlab] + used) PositionDistance(x, y);
+   position->setDistance(distance);
+   used++;
+   numMade++;
+
+   return position;
+}
+
+void PDArena::reset() {
+   currentSlab = -1;
+   used = 0;
+   numMade = 0;
+}
+
+int PDArena::size() {
+   return numMade;
+}
+
+long PDArena::bytes() {
+   long total = 0;
+   for(int slabSize : slabSizes) {
+      total += (long) slabSize * sizeof(PositionDistance);
+   }
+   return total;
+}
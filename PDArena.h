@@ -0,0 +1,63 @@
+#ifndef COSC_ASS_ONE_POSITION_ARENA
+#define COSC_ASS_ONE_POSITION_ARENA
+
+#include "PositionDistance.h"
+
+#include <vector>
+
+// Size of the first slab of an arena, unless the arena is told how many positions to expect
+#define PDARENA_FIRST_SLAB 64
+
+// Slabs stop doubling at this many positions
+#define PDARENA_MAX_SLAB 65536
+
+// Storage for many position-distances at once.
+//    Positions are made one after another in slabs, so making one is a bump of
+//    a counter instead of a call to new. They are never deleted on their own,
+//    reset() forgets every position in one go and keeps the slabs for reuse,
+//    and the destructor frees the slabs.
+//    Each slab is twice the size of the last one (up to PDARENA_MAX_SLAB), so
+//    a small arena stays small and a big one only needs a few slabs.
+class PDArena {
+public:
+
+   // Create an empty arena, the first slab holds firstSlab positions
+   PDArena(int firstSlab = PDARENA_FIRST_SLAB);
+
+   // Free every slab
+   //    Every position made by the arena is gone after this
+   ~PDArena();
+
+   // Make a new position in the arena
+   PDPtr make(int x, int y, int distance);
+
+   // Forget every position made so far, the slabs are kept
+   void reset();
+
+   // Number of positions made since the last reset
+   int size();
+
+   // Number of bytes held by the slabs, including the ones kept after a reset
+   long bytes();
+
+   PDArena(PDArena& other) = delete;
+   PDArena& operator=(PDArena& other) = delete;
+
+private:
+
+   // The slabs, and the number of positions each one holds
+   std::vector<PositionDistance*> slabs;
+   std::vector<int> slabSizes;
+
+   // The slab positions are being made in, and how many are used in it
+   int currentSlab;
+   int used;
+
+   // Number of positions made since the last reset
+   int numMade;
+
+   // Number of positions the first slab holds
+   int firstSlab;
+};
+
+#endif // COSC_ASS_ONE_POSITION_ARENA
@@ -0,0 +1,51 @@
+#include "PDArray.h"
+
+PDArray::PDArray() {
+}
+
+PDArray::PDArray(PDList& list) {
+   reserve(list.size());
+   for(int i = 0; i < list.size(); ++i) {
+      addBack(list.get(i));
+   }
+}
+
+PositionDistance PDArray::get(int i) {
+   PositionDistance position(xs[i], ys[i]);
+   position.setDistance(distances[i]);
+   return position;
+}
+
+void PDArray::addBack(PDPtr position) {
+   addBack(position->getX(), position->getY(), position->getDistance());
+}
+
+void PDArray::append(PDArray& other, int first, int count) {
+
+   // One block copy for each array
+   xs.insert(xs.end(), other.xs.begin() + first, other.xs.begin() + first + count);
+   ys.insert(ys.end(), other.ys.begin() + first, other.ys.begin() + first + count);
+   distances.insert(distances.end(), other.distances.begin() + first,
+                    other.distances.begin() + first + count);
+}
+
+void PDArray::reserve(int n) {
+   xs.reserve(n);
+   ys.reserve(n);
+   distances.reserve(n);
+}
+
+void PDArray::clear() {
+   xs.clear();
+   ys.clear();
+   distances.clear();
+}
+
+PDList* PDArray::toList(int first) {
+   int count = size() - first;
+   PDList* list = new PDList(new PDArena(count), true);
+   for(int i = first; i < size(); ++i) {
+      list->addBack(xs[i], ys[i], distances[i]);
+   }
+   return list;
+}
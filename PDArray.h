@@ -0,0 +1,76 @@
+#ifndef COSC_ASS_ONE_POSITION_ARRAY
+#define COSC_ASS_ONE_POSITION_ARRAY
+
+#include "PDList.h"
+#include "PositionDistance.h"
+
+#include <vector>
+
+// A compact list of position-distances, stored as three parallel arrays.
+//    PDList keeps a pointer to every position, so reading a position means
+//    following the pointer. PDArray keeps every x-co-ordinate next to each
+//    other (and the same for y and the distance), so a scan over one of them
+//    reads memory in order and the compiler can vectorise it.
+//    get and addBack(PDPtr) are there so code written for PDList still works,
+//    but they copy the position instead of handing out a pointer.
+class PDArray {
+public:
+
+   // Create a New Empty Array
+   PDArray();
+
+   // Copy every position of a PDList
+   PDArray(PDList& list);
+
+   // Number of items in the array
+   int size() { return (int) xs.size(); }
+
+   // x-co-ordinate, y-co-ordinate and distance of the position at index i
+   int getX(int i) { return xs[i]; }
+   int getY(int i) { return ys[i]; }
+   int getDistance(int i) { return distances[i]; }
+
+   // Add a position at (x,y) with the given distance to the back
+   void addBack(int x, int y, int distance) {
+      xs.push_back(x);
+      ys.push_back(y);
+      distances.push_back(distance);
+   }
+
+   // Copy of the position at index i, the same as PDList::get but not a pointer
+   PositionDistance get(int i);
+
+   // Add a copy of the given position to the back
+   //    The array does not take control of the pointer, the caller still has to delete it
+   void addBack(PDPtr position);
+
+   // Add count positions of other, starting at index first, to the back
+   void append(PDArray& other, int first, int count);
+
+   // Make room for n positions, so adding them does not allocate again
+   void reserve(int n);
+
+   // Remove everything from the array, the memory is kept for reuse
+   void clear();
+
+   // Number of bytes held by the arrays, including the room kept for reuse
+   long bytes() { return (long) (xs.capacity() + ys.capacity() + distances.capacity()) * sizeof(int); }
+
+   // The arrays themselves, for scans over every position
+   const int* getXs() { return xs.data(); }
+   const int* getYs() { return ys.data(); }
+   const int* getDistances() { return distances.data(); }
+
+   // Make a PDList with a copy of the positions from index first to the back
+   //    The list is made in an arena of its own (see PDList(PDArena*, bool)) and is owned by the caller
+   PDList* toList(int first);
+
+private:
+
+   // The x-co-ordinates, y-co-ordinates and distances, position i is at index i of each
+   std::vector<int> xs;
+   std::vector<int> ys;
+   std::vector<int> distances;
+};
+
+#endif // COSC_ASS_ONE_POSITION_ARRAY
@@ -1,29 +1,60 @@
 #include "PDList.h"
 
+#include "PlannerStats.h"
+
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
 
 
 PDList::PDList() {
+   init(nullptr, false);
+}
+
+PDList::PDList(PDArena* arena, bool ownsArena) {
+   init(arena, ownsArena);
+}
+
+void PDList::init(PDArena* arena, bool ownsArena) {
 
    // Initalising the list size to 0 when it is created
+   // No chunk is allocated until the first position is added
+   chunks = nullptr;
+   numChunks = 0;
+   chunkCapacity = 0;
    numPositions = 0;
+
+   this->arena = arena;
+   this->ownsArena = ownsArena;
 }
 
 PDList::~PDList() {
    clear();
+
+   // clear() keeps the chunks for reuse, so free them here
+   for(int i = 0; i < numChunks; ++i) {
+      delete[] chunks[i];
+      chunks[i] = nullptr;
+   }
+   delete[] chunks;
+   chunks = nullptr;
+
+   if(ownsArena) {
+      delete arena;
+   }
+   arena = nullptr;
 }
 
 PDList::PDList(PDList& other) {
 
-   // Shallow copy
-   numPositions = other.numPositions;
+   // One slab big enough for every position of the other list
+   init(new PDArena(other.numPositions), true);
 
    // Deep copy
    for(int i = 0; i < other.numPositions; ++i) {
-      positions[i] = new PositionDistance(*other.positions[i]);
-   }  
+      PDPtr position = other.get(i);
+      addBack(position->getX(), position->getY(), position->getDistance());
+   }
 }
 
 int PDList::size() {
@@ -33,23 +64,68 @@ int PDList::size() {
 PDPtr PDList::get(int i) {
 
    // Getting a position eg. (8,2,0) from the array
-   PDPtr getPtr = positions[i];
+   // The upper bits pick the chunk, the lower bits pick the slot in the chunk
+   PDPtr getPtr = chunks[i >> PDLIST_CHUNK_BITS][i & PDLIST_CHUNK_MASK];
    return getPtr;
 }
 
 void PDList::addBack(PDPtr position) {
 
-   // If list is full, position cannot be added, error message will be displayed and it will be deleted 
-   // Else, add position to the list
-   if(numPositions != ARRAY_SIZE) {  
-      positions[numPositions] = position;
-      numPositions++;
-   } 
-   else {
-      std::cout << "Error! Array is currently full!" << std::endl;
-      delete position;
-      position = nullptr;
+   // Make sure the chunk for the next index exists, then store the position in it
+   reserveBack();
+   chunks[numPositions >> PDLIST_CHUNK_BITS][numPositions & PDLIST_CHUNK_MASK] = position;
+   numPositions++;
+
+   // The list owns its arena, so this position did not come from it
+   if(ownsArena) {
+      handedOver.push_back(position);
+   }
+}
+
+void PDList::addBack(int x, int y, int distance) {
+   PDPtr position = NULL;
+   if(arena != nullptr) {
+      position = arena->make(x, y, distance);
+   } else {
+      position = new PositionDistance(x, y);
+      position->setDistance(distance);
    }
+
+   reserveBack();
+   chunks[numPositions >> PDLIST_CHUNK_BITS][numPositions & PDLIST_CHUNK_MASK] = position;
+   numPositions++;
+}
+
+long PDList::bytes() {
+   long total = (long) chunkCapacity * sizeof(PDPtr*) + (long) numChunks * PDLIST_CHUNK_SIZE * sizeof(PDPtr);
+   if(ownsArena) {
+      total += arena->bytes() + (long) handedOver.capacity() * sizeof(PDPtr);
+   }
+   return total;
+}
+
+void PDList::reserveBack() {
+
+   // The next index still fits in the chunks that are already allocated
+   if(numPositions < numChunks * PDLIST_CHUNK_SIZE) {
+      return;
+   }
+
+   // The chunk directory is full, so double it
+   // Only the chunk pointers are copied, the positions stay where they are
+   if(numChunks == chunkCapacity) {
+      int newCapacity = chunkCapacity == 0 ? PDLIST_INITIAL_CHUNKS : chunkCapacity * 2;
+      PDPtr** newChunks = new PDPtr*[newCapacity];
+      for(int i = 0; i < numChunks; ++i) {
+         newChunks[i] = chunks[i];
+      }
+      delete[] chunks;
+      chunks = newChunks;
+      chunkCapacity = newCapacity;
+   }
+
+   chunks[numChunks] = new PDPtr[PDLIST_CHUNK_SIZE];
+   numChunks++;
 }
 
 bool PDList::containsCoordinate(PDPtr position) {
@@ -59,22 +135,36 @@ bool PDList::containsCoordinate(PDPtr position) {
 
    // Check if there the position passed into the parameter exists in the list
    // If the position's x-coordinate and y-coordinate is the same as one of the position in the list, return true
-   for(int i = 0; i < numPositions && boolChecker == false; ++i) {
-      if(positions[i]->getX() == position->getX() && 
-         positions[i]->getY() == position->getY()) {
-         
+   int i = 0;
+   for(; i < numPositions && boolChecker == false; ++i) {
+      PDPtr checkPos = get(i);
+      if(checkPos->getX() == position->getX() &&
+         checkPos->getY() == position->getY()) {
+
          boolChecker = true;
       }
    }
+   PLANNER_STATS_RUN(PlannerStats::countComparisons(i));
 
    return boolChecker;
 }
 
 void PDList::clear() {
 
-   // Delete the values in positions[]
-   for(int i = 0; i < numPositions; ++i) {
-      delete[] positions[i];
-      positions[i] = nullptr;
+   // Delete the positions, the chunks are kept so the list can be refilled without allocating
+   // Positions made in an arena are not deleted one by one, the arena frees them all at once
+   if(arena == nullptr) {
+      for(int i = 0; i < numPositions; ++i) {
+         delete get(i);
+         chunks[i >> PDLIST_CHUNK_BITS][i & PDLIST_CHUNK_MASK] = nullptr;
+      }
    }
-}
\ No newline at end of file
+   else if(ownsArena) {
+      for(PDPtr position : handedOver) {
+         delete position;
+      }
+      handedOver.clear();
+      arena->reset();
+   }
+   numPositions = 0;
+}
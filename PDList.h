@@ -2,9 +2,21 @@
 #ifndef COSC_ASS_ONE_POSITION_LIST
 #define COSC_ASS_ONE_POSITION_LIST
 
+#include "PDArena.h"
 #include "PositionDistance.h"
 #include "Types.h"
-#define ARRAY_SIZE 100
+
+#include <vector>
+
+// Positions are stored in fixed-size chunks so that the list can grow without
+// ever moving the stored pointers (no realloc-and-copy spikes).
+// Chunk size is a power of two so get(i) is a shift and a mask.
+#define PDLIST_CHUNK_BITS 12
+#define PDLIST_CHUNK_SIZE (1 << PDLIST_CHUNK_BITS)
+#define PDLIST_CHUNK_MASK (PDLIST_CHUNK_SIZE - 1)
+
+// Initial number of chunk slots in the chunk directory
+#define PDLIST_INITIAL_CHUNKS 4
 
 class PDList {
 public:
@@ -44,16 +56,57 @@ public:
    /*                                           */
 
    // Copy constructor
+   //    The copy makes its positions in an arena of its own, so copying a list
+   //    of n positions is a few allocations instead of n
    PDList(PDList& other);
 
+   // Create a New Empty List whose positions are made in the given arena
+   //    If ownsArena is false, the arena belongs to someone else and the list
+   //    never deletes any position: every position added with addBack(PDPtr)
+   //    must come from that arena or outlive the list. The arena must outlive the list.
+   //    If ownsArena is true, the list deletes the arena when it is deleted,
+   //    and positions added with addBack(PDPtr) are still deleted one by one.
+   PDList(PDArena* arena, bool ownsArena = false);
+
+   // Add a new position-distance at (x,y) with the given distance to the list
+   //    It is made in the list's arena, or with new if the list has no arena
+   void addBack(int x, int y, int distance);
+
+   // Number of bytes held by the list: its chunks, and its arena if it owns one
+   //    Positions in an arena that belongs to someone else, or added with addBack(PDPtr), are not counted
+   long bytes();
+
    /* This is a suggestion of what you could use. */
    /* You can change this code.                   */
 private:
-   // An array that contains the list of PositionDistance
-   PDPtr positions[ARRAY_SIZE];
+   // Directory of chunks, each chunk holds PDLIST_CHUNK_SIZE positions
+   // Only the directory is ever resized, the chunks themselves never move
+   PDPtr** chunks;
+
+   // Number of chunks that have been allocated
+   int numChunks;
+
+   // Number of slots in the chunk directory
+   int chunkCapacity;
 
    // integer value that counts the number of position in the list
    int numPositions;
+
+   // Where new positions are made, nullptr if they are made with new
+   PDArena* arena;
+
+   // Checks if the list deletes the arena
+   bool ownsArena;
+
+   // Positions handed to a list that owns an arena with addBack(PDPtr)
+   // They are not in the arena, so they are deleted one by one
+   std::vector<PDPtr> handedOver;
+
+   // Set up an empty list
+   void init(PDArena* arena, bool ownsArena);
+
+   // Make sure there is room for one more position at the back of the list
+   void reserveBack();
 };
 
 #endif // COSC_ASS_ONE_POSITION_LIST
@@ -0,0 +1,177 @@
+#include "ParallelFlood.h"
+
+#include <cstring>
+
+// Marks a cell that has not been reached, the same as PathPlanning's UNVISITED
+#define NOT_REACHED -1
+
+ParallelFlood::ParallelFlood(Maze* maze, int numThreads) {
+   this->maze = maze;
+   this->numThreads = numThreads < 1 ? 1 : numThreads;
+
+   distances = new std::atomic<int>[maze->size()];
+   levelBegin = 0;
+   levelEnd = 0;
+   level = 0;
+   claimed.resize(this->numThreads);
+   copyOffsets.resize(this->numThreads);
+
+   phase = PHASE_EXPAND;
+   generation = 0;
+   working = 0;
+
+   // Thread 0 is the thread that calls flood, the others wait in the pool
+   for(int i = 1; i < this->numThreads; ++i) {
+      threads.push_back(std::thread(&ParallelFlood::workerLoop, this, i));
+   }
+}
+
+ParallelFlood::~ParallelFlood() {
+   if(!threads.empty()) {
+      runPhase(PHASE_QUIT);
+      for(std::thread& thread : threads) {
+         thread.join();
+      }
+   }
+
+   delete[] distances;
+   distances = nullptr;
+}
+
+int ParallelFlood::getDistance(int index) {
+   return distances[index].load(std::memory_order_relaxed);
+}
+
+std::vector<int>& ParallelFlood::getReached() {
+   return reached;
+}
+
+int ParallelFlood::getNumThreads() {
+   return numThreads;
+}
+
+void ParallelFlood::workerLoop(int thread) {
+   long seen = 0;
+   bool quit = false;
+
+   while(!quit) {
+      Phase work;
+      {
+         std::unique_lock<std::mutex> lock(poolMutex);
+         workReady.wait(lock, [&]() { return generation != seen; });
+         seen = generation;
+         work = phase;
+      }
+
+      if(work == PHASE_QUIT) {
+         quit = true;
+      } else {
+         doPhase(work, thread, numThreads);
+      }
+
+      std::unique_lock<std::mutex> lock(poolMutex);
+      working--;
+      if(working == 0) {
+         workDone.notify_one();
+      }
+   }
+}
+
+void ParallelFlood::runPhase(Phase work) {
+   {
+      std::unique_lock<std::mutex> lock(poolMutex);
+      phase = work;
+      generation++;
+      working = (int) threads.size();
+   }
+   workReady.notify_all();
+
+   if(work != PHASE_QUIT) {
+      doPhase(work, 0, numThreads);
+   }
+
+   std::unique_lock<std::mutex> lock(poolMutex);
+   workDone.wait(lock, [&]() { return working == 0; });
+}
+
+void ParallelFlood::doPhase(Phase work, int thread, int parts) {
+   if(work == PHASE_EXPAND) {
+      expandSlice(thread, parts);
+   }
+   else if(work == PHASE_COPY && !claimed[thread].empty()) {
+      std::memcpy(reached.data() + levelEnd + copyOffsets[thread],
+                  claimed[thread].data(), sizeof(int) * claimed[thread].size());
+   }
+}
+
+void ParallelFlood::expandSlice(int thread, int parts) {
+   long size = levelEnd - levelBegin;
+   int begin = levelBegin + (int) (size * thread / parts);
+   int end = levelBegin + (int) (size * (thread + 1) / parts);
+
+   std::vector<int>& mine = claimed[thread];
+   mine.clear();
+
+   for(int i = begin; i < end; ++i) {
+      int index = reached[i];
+      for(int move = 0; move < LRUD; ++move) {
+         int next = index + maze->getMove(move);
+
+         // Only one thread can swap the distance away from NOT_REACHED, that thread owns the cell
+         if(maze->isOpen(next) && distances[next].load(std::memory_order_relaxed) == NOT_REACHED) {
+            int expected = NOT_REACHED;
+            if(distances[next].compare_exchange_strong(expected, level + 1,
+                                                       std::memory_order_relaxed)) {
+               mine.push_back(next);
+            }
+         }
+      }
+   }
+}
+
+void ParallelFlood::flood(int fromX, int fromY) {
+
+   // Forget the last flood
+   for(int i = 0; i < maze->size(); ++i) {
+      distances[i].store(NOT_REACHED, std::memory_order_relaxed);
+   }
+   reached.resize(maze->size());
+
+   // Level 0 is the start on its own
+   int startIndex = maze->index(fromX, fromY);
+   distances[startIndex].store(0, std::memory_order_relaxed);
+   reached[0] = startIndex;
+   levelBegin = 0;
+   levelEnd = 1;
+   level = 0;
+
+   while(levelBegin != levelEnd) {
+
+      // Claim the next level, on every thread if the level is big enough
+      bool parallel = !threads.empty() && levelEnd - levelBegin >= PARALLEL_MIN_FRONTIER;
+      int parts = parallel ? numThreads : 1;
+      if(parallel) {
+         runPhase(PHASE_EXPAND);
+      } else {
+         expandSlice(0, 1);
+      }
+
+      // Each thread's cells go straight after the cells of the threads before it
+      int total = 0;
+      for(int i = 0; i < parts; ++i) {
+         copyOffsets[i] = total;
+         total += (int) claimed[i].size();
+      }
+      if(parallel) {
+         runPhase(PHASE_COPY);
+      } else {
+         doPhase(PHASE_COPY, 0, 1);
+      }
+
+      levelBegin = levelEnd;
+      levelEnd += total;
+      level++;
+   }
+
+   reached.resize(levelEnd);
+}
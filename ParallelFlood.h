@@ -0,0 +1,111 @@
+#ifndef COSC_ASS_ONE_PARALLEL_FLOOD
+#define COSC_ASS_ONE_PARALLEL_FLOOD
+
+#include "DistanceField.h"
+#include "Maze.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Levels with fewer cells than this are expanded by the calling thread alone,
+// waking the other threads would cost more than it saves
+#define PARALLEL_MIN_FRONTIER 4096
+
+// Level-synchronous breadth-first flood fill split across a pool of threads.
+//    Each level of the frontier is cut into one slice per thread. A thread
+//    claims a neighbour by swapping its distance from unvisited to the next
+//    level with an atomic compare-and-swap, so every cell is claimed by exactly
+//    one thread, and puts it in its own buffer. The buffers are then copied
+//    next to each other to make the next level, each thread copying its own
+//    buffer to an offset worked out from the buffer sizes, so no lock is held
+//    while cells are expanded or copied.
+//    A cell's distance is the level it was claimed in, so the distances are
+//    exactly the same as the single threaded flood fill.
+class ParallelFlood : public DistanceField {
+public:
+
+   // Create a flood fill for the given maze using numThreads threads (including the calling thread)
+   //    The maze is not owned by the flood fill
+   ParallelFlood(Maze* maze, int numThreads);
+
+   // Stop the threads and clean-up
+   ~ParallelFlood();
+
+   // Flood the maze from (fromX,fromY)
+   void flood(int fromX, int fromY) override;
+
+   // Distance from the start of the cell at the given maze index, or -1 if it was not reached
+   int getDistance(int index) override;
+
+   // Maze indexes of the cells reached by the last flood, in the order of their distance
+   //    The start is the first cell
+   std::vector<int>& getReached() override;
+
+   // Number of threads used, including the calling thread
+   int getNumThreads();
+
+   ParallelFlood(ParallelFlood& other) = delete;
+   ParallelFlood& operator=(ParallelFlood& other) = delete;
+
+private:
+
+   // The work the threads are told to do
+   enum Phase {
+      PHASE_EXPAND,
+      PHASE_COPY,
+      PHASE_QUIT
+   };
+
+   // The maze being flooded
+   Maze* maze;
+
+   // Number of threads, including the calling thread
+   int numThreads;
+
+   // Distance of every cell, by maze index
+   std::atomic<int>* distances;
+
+   // Maze indexes of the cells reached, in the order of their distance
+   //    The current level is reached[levelBegin] to reached[levelEnd - 1]
+   std::vector<int> reached;
+   int levelBegin;
+   int levelEnd;
+
+   // Distance of the cells in the current level
+   int level;
+
+   // The cells each thread claimed for the next level
+   std::vector<std::vector<int>> claimed;
+
+   // Where each thread copies its claimed cells to in reached
+   std::vector<int> copyOffsets;
+
+   // The pool threads (thread 0 is the calling thread, so it is not in here)
+   std::vector<std::thread> threads;
+
+   // Hands out work to the pool: the phase, a counter that changes every time
+   // there is new work, and the number of pool threads still working on it
+   std::mutex poolMutex;
+   std::condition_variable workReady;
+   std::condition_variable workDone;
+   Phase phase;
+   long generation;
+   int working;
+
+   // Wait for work and do it, until told to quit
+   void workerLoop(int thread);
+
+   // Do the given phase on every thread, and wait until they are all done
+   void runPhase(Phase work);
+
+   // Do one thread's part of a phase
+   void doPhase(Phase work, int thread, int parts);
+
+   // Claim the unvisited neighbours of one slice of the current level
+   void expandSlice(int thread, int parts);
+};
+
+#endif // COSC_ASS_ONE_PARALLEL_FLOOD
@@ -1,57 +1,110 @@
 #include "PathPlanning.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <thread>
 
 PathPlanning::PathPlanning(Grid originalMaze, int rows, int cols) {
 
    // Creating a copy of the maze, so that the maze that was passed in will not be corrupted
-   maze = new char*[rows];
-   for(int i = 0; i < rows; ++i) {
-      maze[i] = new char[cols];
-   }
+   // The copy is one flat block with a wall border around it, see Maze.h
+   // A negative size is an empty maze, the grid is then not deleted below
+   maze = new Maze(originalMaze, std::max(rows, 0), std::max(cols, 0));
+   ownsMaze = true;
+   init();
 
-   for(int i = 0; i < rows; ++i) {
-      for(int j = 0; j < cols; ++j) {
-         this->maze[i][j] = originalMaze[i][j];
+   // Delete the maze that was passed in to stop memory leaks
+   if(rows >= 0 && cols >= 0) {
+      for (int i = 0; i < rows; ++i) {
+         delete[] originalMaze[i];
+         originalMaze[i] = nullptr;
       }
+      delete[] originalMaze;
+      originalMaze = nullptr;
    }
+}
+
+PathPlanning::PathPlanning(Maze* maze) {
+
+   // Use the maze as it is, it belongs to the caller
+   this->maze = maze;
+   ownsMaze = false;
+   init();
+}
 
-   this->rows = rows;
-   this->cols = cols;
+void PathPlanning::init() {
+
+   rows = maze->getRows();
+   cols = maze->getCols();
+
+   // One distance per cell of the maze, filled in by getReachablePositions
+   // It uses the same indexes as the maze, including the border
+   distanceGrid = new int[maze->size()];
+   parentGrid = new DirectionGrid(maze->size());
+   fieldStartIndex = UNVISITED;
+   reachedCount = 0;
+   dotListStale = false;
+
+   // The other search engines are only created when they are used
+   aStar = NULL;
+   landmarks = NULL;
+   bidirectional = NULL;
+   jumpPoint = NULL;
+   bitboard = NULL;
+   bitboardStartIndex = UNVISITED;
+   parallel = NULL;
+   parallelStartIndex = UNVISITED;
+   floodThreads = std::thread::hardware_concurrency();
+   hierarchical = NULL;
+   clusterSize = HPA_CLUSTER_SIZE;
+   multiSource = NULL;
+   nodesExpanded = 0;
 
    // Initialise robotInitialPosition that is a PDPtr to NULL
    robotInitialPosition = NULL;
 
-   // Initialise dotList that is a PDList* to NULL
-   dotList = NULL;
+   // The positions of bestPathList are made in this arena, see PDArena.h
+   pathArena = new PDArena();
+
+   // dotList is filled in by every flood fill, and emptied before the next one
+   dotList = new PDArray();
 
    // Initialise bestPathList that is a PDList* to NULL
    bestPathList = NULL;
-
-   // Delete the maze that was passed in to stop memory leaks
-   if(rows >= 0 && cols >= 0) {
-      for (int i = 0; i < rows; ++i) {
-         delete[] originalMaze[i];
-         originalMaze[i] = nullptr;
-      }
-      delete[] originalMaze;
-      originalMaze = nullptr;
-   }
 }
 
 PathPlanning::~PathPlanning() {
 
    // Delete the copied maze to stop memory leaks
-   if (rows >= 0 && cols >= 0) {
-      for (int i = 0; i < rows; ++i) {
-         delete[] maze[i];
-         maze[i] = nullptr;
-      }
-      delete[] maze;
-      maze = nullptr;
+   // A maze that was passed in as a Maze* belongs to the caller
+   if(ownsMaze) {
+      delete maze;
    }
+   maze = nullptr;
+
+   // Delete the search engines
+   delete aStar;
+   aStar = nullptr;
+   delete bidirectional;
+   bidirectional = nullptr;
+   delete jumpPoint;
+   jumpPoint = nullptr;
+   delete bitboard;
+   bitboard = nullptr;
+   delete parallel;
+   parallel = nullptr;
+   delete hierarchical;
+   hierarchical = nullptr;
+   delete multiSource;
+   multiSource = nullptr;
+
+   // Delete the distance grid
+   delete[] distanceGrid;
+   distanceGrid = nullptr;
+   delete parentGrid;
+   parentGrid = nullptr;
 
    // Delete dotList
    delete dotList;
@@ -61,58 +114,209 @@ PathPlanning::~PathPlanning() {
    delete robotInitialPosition;
    robotInitialPosition = nullptr;
 
-   // Delete reachableList
-   delete reachableList;
-   reachableList = nullptr;
-
    // Delete bestPathList
    delete bestPathList;
    bestPathList = nullptr;
+
+   // Delete the arena last, bestPathList was using its positions
+   delete pathArena;
+   pathArena = nullptr;
 }
 
 void PathPlanning::initialPosition(int x, int y) {
+
+   // Replace the old initial position
+   // The distance field is only computed again if the position is different, see updateDistanceField
+   delete robotInitialPosition;
    robotInitialPosition = new PositionDistance(x, y);
 }
 
 PDList* PathPlanning::getReachablePositions() {
+   PLANNER_STATS_RUN(stats.beginQuery());
+
+   PDList* reachable = copyReachable();
+
+   PLANNER_STATS_RUN(finishStats(reachable));
+   return reachable;
+}
+
+PDList* PathPlanning::copyReachable() {
+   PLANNER_STATS_START(phaseStart);
+
+   updateDistanceField();
+   if(dotListStale) {
+      rebuildDotList();
+   }
+   PLANNER_STATS_LAP(stats, floodNanos, phaseStart);
+
+   // The caller owns the returned list, so hand back a deep copy
+   // Every position of dotList except the initial position (the first one) is reachable
+   PDList* reachable = dotList->toList(1);
+   PLANNER_STATS_LAP(stats, copyNanos, phaseStart);
+
+   return reachable;
+}
+
+PDList* PathPlanning::getReachablePositions(SearchEngine engine) {
+   PLANNER_STATS_RUN(stats.beginQuery());
+   PDList* reachable = NULL;
+
+   if(engine == ENGINE_BITBOARD || engine == ENGINE_PARALLEL) {
+      PLANNER_STATS_START(phaseStart);
+      DistanceField* field = updateLevelField(engine);
+      PLANNER_STATS_LAP(stats, floodNanos, phaseStart);
+
+      // The first cell reached is the initial position, which is not in the list
+      // The caller owns the list, so it gets an arena of its own
+      std::vector<int>& reached = field->getReached();
+      reachable = new PDList(new PDArena(reached.size()), true);
+      for(unsigned int i = 1; i < reached.size(); ++i) {
+         reachable->addBack(maze->getX(reached[i]), maze->getY(reached[i]),
+                            field->getDistance(reached[i]));
+      }
+      nodesExpanded = reached.size();
+      PLANNER_STATS_LAP(stats, copyNanos, phaseStart);
+   }
+   else {
+      reachable = copyReachable();
+      nodesExpanded = reachedCount;
+   }
+
+   PLANNER_STATS_RUN(finishStats(reachable));
+   return reachable;
+}
 
-   dotList = new PDList();  
-   reachableList = new PDList();
+void PathPlanning::setFloodThreads(int numThreads) {
+
+   // The pool is started again with the new number of threads when it is next used
+   floodThreads = numThreads;
+   delete parallel;
+   parallel = NULL;
+   parallelStartIndex = UNVISITED;
+}
+
+bool PathPlanning::setLandmarks(LandmarkIndex* landmarks) {
+   bool matches = landmarks == NULL || landmarks->matches(maze);
+
+   this->landmarks = matches ? landmarks : NULL;
+   if(aStar != NULL) {
+      aStar->setLandmarks(this->landmarks);
+   }
+
+   return matches;
+}
+
+void PathPlanning::setClusterSize(int size) {
+   clusterSize = size;
+   delete hierarchical;
+   hierarchical = NULL;
+}
+
+PDList* PathPlanning::getNearestSources(PDList* sources, std::vector<int>& owners) {
+   PLANNER_STATS_RUN(stats.beginQuery());
+   PLANNER_STATS_START(phaseStart);
+
+   if(multiSource == NULL) {
+      multiSource = new MultiSourceFlood(maze);
+   }
+   multiSource->flood(sources);
+   PLANNER_STATS_LAP(stats, floodNanos, phaseStart);
+
+   // The sources are at the front of the cells reached, and are not in the list
+   std::vector<int>& reached = multiSource->getReached();
+   PDList* nearest = new PDList(new PDArena(reached.size()), true);
+   owners.clear();
+   for(unsigned int i = multiSource->getNumSources(); i < reached.size(); ++i) {
+      nearest->addBack(maze->getX(reached[i]), maze->getY(reached[i]),
+                       multiSource->getDistance(reached[i]));
+      owners.push_back(multiSource->getOwner(reached[i]));
+   }
+   nodesExpanded = reached.size();
+   PLANNER_STATS_LAP(stats, copyNanos, phaseStart);
+   PLANNER_STATS_ADD(stats, nodesExpanded, reached.size());
+
+   PLANNER_STATS_RUN(finishStats(NULL));
+   return nearest;
+}
+
+DistanceField* PathPlanning::updateLevelField(SearchEngine engine) {
+   DistanceField* field = NULL;
+   int* fieldStart = NULL;
+
+   if(engine == ENGINE_PARALLEL) {
+      if(parallel == NULL) {
+         parallel = new ParallelFlood(maze, floodThreads);
+      }
+      field = parallel;
+      fieldStart = &parallelStartIndex;
+   }
+   else {
+      if(bitboard == NULL) {
+         bitboard = new BitboardFlood(maze);
+      }
+      field = bitboard;
+      fieldStart = &bitboardStartIndex;
+   }
+
+   int startIndex = maze->index(robotInitialPosition->getX(), robotInitialPosition->getY());
+   if(startIndex != *fieldStart) {
+      field->flood(robotInitialPosition->getX(), robotInitialPosition->getY());
+      *fieldStart = startIndex;
+      PLANNER_STATS_ADD(stats, nodesExpanded, field->getReached().size());
+   }
+
+   return field;
+}
+
+void PathPlanning::updateDistanceField() {
+
+   // The distance field from this initial position is still there, nothing to do
+   int startIndex = maze->index(robotInitialPosition->getX(), robotInitialPosition->getY());
+   if(startIndex == fieldStartIndex) {
+      return;
+   }
+   fieldStartIndex = startIndex;
+
+   // Empty the list from the last initial position, its memory is kept for this one
+   dotList->clear();
+
+   // Mark every cell as not reached yet
+   for(int i = 0; i < maze->size(); ++i) {
+      distanceGrid[i] = UNVISITED;
+   }
 
    // Add robot's initial position into dotList
-   dotList->addBack(new PositionDistance(*robotInitialPosition));
+   dotList->addBack(robotInitialPosition->getX(), robotInitialPosition->getY(), 0);
+   distanceGrid[maze->index(robotInitialPosition->getX(), robotInitialPosition->getY())] = 0;
    
-   // Creating a temporary list
-   // The temporary list is checker used to make sure that all the acceptable positions the robot can go to is checked
-   PDList* tempList = new PDList();
+   // Counts the positions of dotList that have been checked
+   // It is used to make sure that all the acceptable positions the robot can go to is checked
+   // (this used to be a temporary list holding a copy of every checked position, only its size was used)
+   int checked = 0;
 
-   // Creating 2 PDPtr
-   // addPos PDPtr is used to hold a position that the robot can go from its position
-   // tmp PDPtr is used to store a position that is next to addPos
+   // Declaring 5 variables and initalising them to 0
+   // addX and addY variables are used to store the currently checking position
    // For example, if the robot is currently at (6,3), the robot can go to (6,2) or (6,4) or (7,3) or (5,3)
-   // By using a for loop, all positions are dealt with individually
-   PDPtr addPos = NULL;
-   PDPtr tmpPos = NULL;
-
-   // Declaring 3 variables and initalising them to 0
    // posX and posY variables are used to store the individual values of the positions the robot can go to
    // dist variable is used to store the current position of the robot
+   int addX = 0;
+   int addY = 0;
    int posX = 0;
    int posY = 0;
    int dist = 0;
 
-   // if tempList is smaller than dotList, then there is a position in list that has not been checked. Therefore, that position has to be checked.
-   while((tempList->size()) != (dotList->size())) {
+   // if checked is smaller than dotList, then there is a position in list that has not been checked. Therefore, that position has to be checked.
+   while(checked != dotList->size()) {
       
-      // Assume dotList contains (8,2) while tempList is empty
-      // The size of tempList will be 0
-      // Therefore, dotList-> get(0) will get us (8,2)
-      // And since it is a PDPtr, addPos has to be initialised as a PDPtr.
-      // addPos is also known as the currently checking position
-      addPos = dotList->get(tempList->size());  
+      // Assume dotList contains (8,2) while nothing has been checked
+      // checked will be 0
+      // Therefore, position 0 of dotList will be (8,2)
+      // This is also known as the currently checking position
+      addX = dotList->getX(checked);
+      addY = dotList->getY(checked);
 
       // Get the distance of the position it is checking at store it in the dist variable
-      dist = addPos->getDistance();
+      dist = dotList->getDistance(checked);
       
       // moveHorizontal{ "moving left", "moving right", "moving up", "moving down" }
       // moveVertical{ "moving left", "moving right", "moving up", "moving down" }
@@ -126,50 +330,236 @@ PDList* PathPlanning::getReachablePositions() {
       int moveHorizontal[LRUD] = {-1, 1, 0, 0};
       int moveVertical[LRUD] = {0, 0, -1, 1};
 
+      // The same moves as index offsets in the maze buffer, see Maze::getMove
+      // The border around the maze means a neighbour index is always inside the buffer
+      int addIndex = maze->index(addX, addY);
+
       for(int i = 0; i < LRUD; ++i) {
-         posX = addPos->getX() + moveHorizontal[i];
-         posY = addPos->getY() + moveVertical[i];
-   
-         // Take a position that is left or right or up or down for checking in the if-statement below
-         tmpPos = new PositionDistance(posX, posY);
+         posX = addX + moveHorizontal[i];
+         posY = addY + moveVertical[i];
+         int posIndex = addIndex + maze->getMove(i);
 
          // Checks if the next position is a '.' on the maze. 
          // If it is, there is a position that the robot can go to
          // Increase the dist variable by 1 and add the position inside the dotList
-         // However, if the next position is not a '.', the values in the position will be deleted
-         if(!dotList->containsCoordinate(tmpPos) && maze[posY][posX] == '.') {
-            tmpPos->setDistance(dist + 1);
-            dotList->addBack(tmpPos);
-         } 
-         else {
-            delete tmpPos;
+         // The distance grid tells us in O(1) if the position is already in dotList
+         if(distanceGrid[posIndex] == UNVISITED && maze->isOpen(posIndex)) {
+            distanceGrid[posIndex] = dist + 1;
+            parentGrid->set(posIndex, i);
+            dotList->addBack(posX, posY, dist + 1);
          }
       }
 
-      // Now that the position has been checked, add this position inside the tempList to show that this position has been checked
+      // Now that the position has been checked, count it to show that this position has been checked
       // This is used for the condition of the while loop
-      tempList->addBack(new PositionDistance(*addPos));
-   }
-
-   // This is used to copy the dotList into reachableList
-   // addReachPos will be the variable used
-   for(int i = 1; i < dotList->size(); ++i) {
-      PDPtr addReachPos = dotList->get(i);
-      reachableList->addBack(new PositionDistance(*addReachPos));
+      checked++;
    }
-
-   // Once dotList and reachableList has been populated with the right pointers, tempList is no longer of use
-   // Therefore, tempList will be deleted
-   delete tempList;
-   tempList = nullptr;
+   reachedCount = dotList->size();
+   dotListStale = false;
+   PLANNER_STATS_ADD(stats, nodesExpanded, checked);
+   PLANNER_STATS_ADD(stats, neighbourProbes, LRUD * checked);
 
    // This is used to help get outputs when creating unit tests
    // It displays the(x,y,distance)
-   // for(int i = 0; i < reachableList->size(); ++i) {
-   //    std::cout << "(" << reachableList->get(i)->getX() << "," << reachableList->get(i)->getY() << "," << reachableList->get(i)->getDistance() << ")" << std::endl; 
+   // for(int i = 1; i < dotList->size(); ++i) {
+   //    std::cout << "(" << dotList->getX(i) << "," << dotList->getY(i) << "," << dotList->getDistance(i) << ")" << std::endl; 
    // }
+}
 
-   return reachableList;
+bool PathPlanning::setCell(int x, int y, char cell) {
+   bool changed = false;
+
+   if(x >= 0 && x < cols && y >= 0 && y < rows) {
+      PLANNER_STATS_RUN(stats.beginQuery());
+      PLANNER_STATS_START(phaseStart);
+      int index = maze->index(x, y);
+      bool wasOpen = maze->isOpen(index);
+      maze->setCell(x, y, cell);
+      changed = true;
+
+      // The bitboards and the cluster graph are made from the maze, so they are made again when they are next used
+      // The other flood fills read the maze itself, they only have to run again
+      delete bitboard;
+      bitboard = NULL;
+      delete hierarchical;
+      hierarchical = NULL;
+      bitboardStartIndex = UNVISITED;
+      parallelStartIndex = UNVISITED;
+
+      // The landmark distances are for the maze as it was, so they could now be too big
+      setLandmarks(NULL);
+
+      // The initial position is always flooded from, whatever is on it, so it changes nothing
+      if(fieldStartIndex != UNVISITED && index != fieldStartIndex) {
+         if(!wasOpen && maze->isOpen(index)) {
+            repairOpened(index);
+         } else if(wasOpen && !maze->isOpen(index)) {
+            repairClosed(index);
+         }
+      }
+      PLANNER_STATS_LAP(stats, floodNanos, phaseStart);
+      PLANNER_STATS_RUN(finishStats(NULL));
+   }
+
+   return changed;
+}
+
+void PathPlanning::repairOpened(int index) {
+
+   // The new cell is one further than its closest reached neighbour
+   int best = UNVISITED;
+   for(int i = 0; i < LRUD; ++i) {
+      int from = index - maze->getMove(i);
+      if(distanceGrid[from] != UNVISITED && (best == UNVISITED || distanceGrid[from] + 1 < best)) {
+         best = distanceGrid[from] + 1;
+         parentGrid->set(index, i);
+      }
+   }
+   if(best == UNVISITED) {
+      return;
+   }
+   distanceGrid[index] = best;
+   reachedCount++;
+   dotListStale = true;
+
+   // Spread out from the new cell, only cells that get closer are visited
+   // There is only one cell to start from, so the queue is in order of distance
+   std::vector<int> queue;
+   queue.push_back(index);
+   for(unsigned int head = 0; head < queue.size(); ++head) {
+      int current = queue[head];
+      PLANNER_STATS_ADD(stats, nodesExpanded, 1);
+      PLANNER_STATS_ADD(stats, neighbourProbes, LRUD);
+      for(int i = 0; i < LRUD; ++i) {
+         int next = current + maze->getMove(i);
+         if(maze->isOpen(next) &&
+            (distanceGrid[next] == UNVISITED || distanceGrid[current] + 1 < distanceGrid[next])) {
+            if(distanceGrid[next] == UNVISITED) {
+               reachedCount++;
+            }
+            distanceGrid[next] = distanceGrid[current] + 1;
+            parentGrid->set(next, i);
+            queue.push_back(next);
+         }
+      }
+   }
+}
+
+void PathPlanning::repairClosed(int index) {
+   if(distanceGrid[index] == UNVISITED) {
+      return;
+   }
+
+   // Every cell whose stored move leads back through the closed cell may be further away now
+   // They are found by following the moves forwards from it
+   std::vector<int> affected;
+   affected.push_back(index);
+   for(unsigned int i = 0; i < affected.size(); ++i) {
+      int current = affected[i];
+      PLANNER_STATS_ADD(stats, neighbourProbes, LRUD);
+      for(int move = 0; move < LRUD; ++move) {
+         int next = current + maze->getMove(move);
+         if(distanceGrid[next] != UNVISITED && next != fieldStartIndex &&
+            next - maze->getMove(parentGrid->get(next)) == current) {
+            affected.push_back(next);
+         }
+      }
+   }
+   for(int cell : affected) {
+      distanceGrid[cell] = UNVISITED;
+   }
+   reachedCount -= affected.size();
+   dotListStale = true;
+
+   // Each affected cell can start again from its closest neighbour that was not affected
+   std::vector<std::pair<int, int>> seeds;
+   for(int cell : affected) {
+      if(maze->isOpen(cell)) {
+         int best = UNVISITED;
+         int bestMove = 0;
+         for(int i = 0; i < LRUD; ++i) {
+            int from = cell - maze->getMove(i);
+            if(distanceGrid[from] != UNVISITED && (best == UNVISITED || distanceGrid[from] + 1 < best)) {
+               best = distanceGrid[from] + 1;
+               bestMove = i;
+            }
+         }
+         if(best != UNVISITED) {
+            distanceGrid[cell] = best;
+            parentGrid->set(cell, bestMove);
+            seeds.push_back(std::make_pair(best, cell));
+            reachedCount++;
+         }
+      }
+   }
+   std::sort(seeds.begin(), seeds.end());
+
+   // Flood the affected cells from the seeds in order of distance: a seed joins when the
+   // queue gets to its distance, so every cell is still reached first by its shortest way
+   std::vector<int> queue;
+   unsigned int head = 0;
+   unsigned int nextSeed = 0;
+   while(head < queue.size() || nextSeed < seeds.size()) {
+      int current = 0;
+      if(head < queue.size() &&
+         (nextSeed == seeds.size() || distanceGrid[queue[head]] <= seeds[nextSeed].first)) {
+         current = queue[head];
+         head++;
+      } else {
+         current = seeds[nextSeed].second;
+         nextSeed++;
+         if(distanceGrid[current] != seeds[nextSeed - 1].first) {
+            continue;
+         }
+      }
+      PLANNER_STATS_ADD(stats, nodesExpanded, 1);
+      PLANNER_STATS_ADD(stats, neighbourProbes, LRUD);
+
+      for(int i = 0; i < LRUD; ++i) {
+         int next = current + maze->getMove(i);
+         if(maze->isOpen(next) &&
+            (distanceGrid[next] == UNVISITED || distanceGrid[current] + 1 < distanceGrid[next])) {
+            if(distanceGrid[next] == UNVISITED) {
+               reachedCount++;
+            }
+            distanceGrid[next] = distanceGrid[current] + 1;
+            parentGrid->set(next, i);
+            queue.push_back(next);
+         }
+      }
+   }
+}
+
+void PathPlanning::rebuildDotList() {
+
+   // Count the reached cells at every distance, then place them in order of distance
+   std::vector<int> counts;
+   for(int i = 0; i < maze->size(); ++i) {
+      if(distanceGrid[i] != UNVISITED) {
+         if(distanceGrid[i] >= (int) counts.size()) {
+            counts.resize(distanceGrid[i] + 1, 0);
+         }
+         counts[distanceGrid[i]]++;
+      }
+   }
+   std::vector<int> starts(counts.size() + 1, 0);
+   for(unsigned int d = 0; d < counts.size(); ++d) {
+      starts[d + 1] = starts[d] + counts[d];
+   }
+   std::vector<int> order(starts.back());
+   for(int i = 0; i < maze->size(); ++i) {
+      if(distanceGrid[i] != UNVISITED) {
+         order[starts[distanceGrid[i]]] = i;
+         starts[distanceGrid[i]]++;
+      }
+   }
+
+   dotList->clear();
+   dotList->reserve(order.size());
+   for(int index : order) {
+      dotList->addBack(maze->getX(index), maze->getY(index), distanceGrid[index]);
+   }
+   dotListStale = false;
 }
 
 // THIS IS FOR MILESTONE 3 ONLY
@@ -186,127 +576,203 @@ PDList* PathPlanning::getReachablePositions() {
 
    Start from end to robot
 
-   while(distance is not 0) (not the robot position (8, 2, 0))
-
-      1) Get the pointer to be checked from bestPathList.
-      End coordinate = 7, 1
-
-      2) Get the coordinates from this pointer.
-      x = 7, y = 1
-
-      3) Get Distance of the coordinate
-      distance = 2
+   getReachablePositions stores the move that first reached every position in parentGrid.
+   For (7,1) that move is "left" from (8,1), and for (8,1) it is "up" from (8,2).
 
-      4) Get all coordinates of (distance - 1) from dotList and put it in similiarDistanceList.
-      Coordinates = 8, 1 & 8, 3
+   while(distance is not 0) (not the robot position (8, 2, 0))
 
-      5) Using a for loop, check if the individual positions in similarDistanceList is 1 x-coordinate/y-coordinate away from the current checking position.
-      Only 8, 1 is accepted
+      1) Get the move stored for the current position.
+      End coordinate = 7, 1, move = left
 
-      6) Put 8, 1 in the addingPointerToBPList
+      2) Undo the move to get the position it came from.
+      8, 1
 
-      7) Add whatever is in addingPointerToBPList to bestPathList
+      3) Add that position to bestPathList, its distance is one less.
+      8, 1, 1
 
-      While End (Loop if distance added in to bestPathList from Step 7 is 0)
+      While End (Loop if distance added in to bestPathList from Step 3 is 0)
 
-      8) Delete similarDistanceList.
-      9) Delete addingPointerToBPList.
-      10) Display bestPathList. (return this list actually)
+      4) Display bestPathList. (return a copy of this list actually)
 
-      Remember to delete bestPathList after everything is done.
+   The position that first reached a cell is the first one in dotList next to it with distance - 1,
+   so this gives the same path as checking the positions in dotList one by one.
 */
 PDList* PathPlanning::getPath(int toX, int toY) {
+   return getPath(toX, toY, ENGINE_FLOOD);
+}
 
-   bestPathList = new PDList();
+PDList* PathPlanning::getPath(int toX, int toY, SearchEngine engine) {
+   PLANNER_STATS_RUN(stats.beginQuery());
+   PLANNER_STATS_START(phaseStart);
 
-   // This variable is used to store the index of the position in the dotList in the for loop below
-   int endCoorIndexInList = 0;
+   // Delete the path from the last call before making a new one
+   delete bestPathList;
+   pathArena->reset();
+   bestPathList = new PDList(pathArena);
 
-   // This variable is created to stop the for loop once the condition of the if-statement is met and executed
-   bool endCoorExists = false;
+   int fromX = robotInitialPosition->getX();
+   int fromY = robotInitialPosition->getY();
 
-   // This for loop is used to find the end position from the dotList
-   // endCoorIndexInList is used to store the index of the position in the dotList
-   for(int i = 0; i < dotList->size() && endCoorExists == false; ++i) {
-      if((dotList->get(i))->getX() == toX &&
-      (dotList->get(i))->getY() == toY) {
-         endCoorIndexInList = i;
-         endCoorExists = true;
+   switch(engine) {
+      case ENGINE_ASTAR:
+         if(aStar == NULL) {
+            aStar = new AStarSearch(maze);
+            aStar->setLandmarks(landmarks);
+         }
+         aStar->findPath(fromX, fromY, toX, toY, bestPathList);
+         nodesExpanded = aStar->getNodesExpanded();
+         PLANNER_STATS_ADD(stats, nodesExpanded, nodesExpanded);
+         break;
+
+      case ENGINE_BIDIRECTIONAL:
+         if(bidirectional == NULL) {
+            bidirectional = new BidirectionalSearch(maze);
+         }
+         bidirectional->findPath(fromX, fromY, toX, toY, bestPathList);
+         nodesExpanded = bidirectional->getNodesExpanded();
+         PLANNER_STATS_ADD(stats, nodesExpanded, nodesExpanded);
+         break;
+
+      case ENGINE_JPS:
+         if(jumpPoint == NULL) {
+            jumpPoint = new JumpPointSearch(maze);
+         }
+         jumpPoint->findPath(fromX, fromY, toX, toY, bestPathList);
+         nodesExpanded = jumpPoint->getNodesExpanded();
+         PLANNER_STATS_ADD(stats, nodesExpanded, nodesExpanded);
+         break;
+
+      case ENGINE_HIERARCHICAL:
+         if(hierarchical == NULL) {
+            hierarchical = new HierarchicalSearch(maze, clusterSize, floodThreads);
+         }
+         hierarchical->findPath(fromX, fromY, toX, toY, bestPathList);
+         nodesExpanded = hierarchical->getNodesExpanded();
+         PLANNER_STATS_ADD(stats, nodesExpanded, nodesExpanded);
+         break;
+
+      case ENGINE_BITBOARD:
+      case ENGINE_PARALLEL: {
+         DistanceField* field = updateLevelField(engine);
+         PLANNER_STATS_LAP(stats, floodNanos, phaseStart);
+         traceFieldPath(field, toX, toY, bestPathList);
+         PLANNER_STATS_LAP(stats, traceNanos, phaseStart);
+         nodesExpanded = field->getReached().size();
+         break;
       }
+
+      case ENGINE_FLOOD:
+      default:
+         updateDistanceField();
+         PLANNER_STATS_LAP(stats, floodNanos, phaseStart);
+         tracePath(toX, toY, bestPathList);
+         PLANNER_STATS_LAP(stats, traceNanos, phaseStart);
+         nodesExpanded = reachedCount;
+         break;
    }
 
-   /* ---------------------------------- */
+   // This is used to help get outputs when creating unit tests
+   // It displays the(x,y,distance)
+   // for(int i = bestPathList->size() - 1; i >= 0; i = i - 1) {
+   //    std::cout << "(" << bestPathList->get(i)->getX() << "," << bestPathList->get(i)->getY() << "," << bestPathList->get(i)->getDistance() << ")" << std::endl; 
+   // }
 
-   // This variable hold the index of coordinate to be checked in the bestPathList
-   // It will always increase by 1 until the currently checking position has a distance of 0
-   int indexOfCoorToCheckInBPList = 0;
+   // The searches find the path as they go, so all of their time is flood time
+   PLANNER_STATS_LAP(stats, floodNanos, phaseStart);
 
-   // Declaring newCoorDistance variable and initialising it to 1
-   // The reason why it is 1 and not 0 is because of the while loop below
-   // When the value passed into the variable is 0, that means the position is now at where the robot is
-   int newCoorDistance = 1;
+   // The caller owns the returned list, so hand back a deep copy
+   PDList* path = new PDList(*bestPathList);
+   PLANNER_STATS_LAP(stats, copyNanos, phaseStart);
 
-   // Add end position to bestPathList
-   bestPathList->addBack(new PositionDistance( *(dotList->get(endCoorIndexInList)) ) );
+   PLANNER_STATS_RUN(finishStats(NULL));
+   return path;
+}
 
-   while(newCoorDistance != 0) {
+int PathPlanning::getNodesExpanded() {
+   return nodesExpanded;
+}
 
-      // Creating 2 new lists
-      // similarDistanceList contains positions that are from dotList
-      // These positions must be checked if they are beside the currently checking position
-      // If it is, the positions will be added to addingPointerToBPList
-      // addingPointerToBPList contains a position that is from similarDistanceList
-      // This position that will be added in bestPathList
-      PDList* similarDistanceList = new PDList();
-      PDList* addingPointerToBPList = new PDList();      
+PlannerStats& PathPlanning::getStats() {
+   return stats;
+}
 
-      // These 3 variables declared are the coordinates and distance of the currently checking position
-      int x = bestPathList->get(indexOfCoorToCheckInBPList)->getX();
-      int y = bestPathList->get(indexOfCoorToCheckInBPList)->getY();
-      int distance = bestPathList->get(indexOfCoorToCheckInBPList)->getDistance();
+void PathPlanning::finishStats(PDList* reachable) {
 
-      // The next distance to check is distance -1
-      newCoorDistance = distance - 1;
+   // The distance grid has an int for every cell of the maze, including the border
+   stats.fieldBytes = (long) maze->size() * sizeof(int) + parentGrid->bytes();
+   stats.dotListBytes = dotList->bytes();
+   stats.bestPathListBytes = bestPathList == NULL ? 0 : bestPathList->bytes() + pathArena->bytes();
+   if(reachable != NULL) {
+      stats.reachableListBytes = reachable->bytes();
+   }
+   stats.endQuery();
+}
 
-      // Add all potential positions to similarDistanceList.
-      for(int i = 0; i < dotList->size(); ++i) {
-         if( (dotList->get(i))->getDistance() == newCoorDistance) {
-            similarDistanceList->addBack(new PositionDistance( *(dotList->get(i)) ) );
-         }
-      }
+std::vector<PDList*> PathPlanning::getPaths(PDList* goals) {
+   PLANNER_STATS_RUN(stats.beginQuery());
+   PLANNER_STATS_START(phaseStart);
+
+   // One flood fill answers every goal
+   updateDistanceField();
+   PLANNER_STATS_LAP(stats, floodNanos, phaseStart);
+
+   // Each path goes straight into the list handed to the caller, nothing is kept here
+   std::vector<PDList*> paths;
+   for(int i = 0; i < goals->size(); ++i) {
+      PDList* path = new PDList(new PDArena(), true);
+      tracePath(goals->get(i)->getX(), goals->get(i)->getY(), path);
+      paths.push_back(path);
+   }
+   PLANNER_STATS_LAP(stats, traceNanos, phaseStart);
+
+   PLANNER_STATS_RUN(finishStats(NULL));
+   return paths;
+}
 
-      // Check the positions x-coordinate and y-coordinate in similarDistanceList, and only add the correct position to addingPointerToBPList.
-      for(int i = 0; i < similarDistanceList->size(); ++i) {
-         int checkX = similarDistanceList->get(i)->getX();
-         int checkY = similarDistanceList->get(i)->getY();
-         
-         // {Left, Right, Up, Down} See milestone 2 functional prototype which is above for explanation
-         int moveHorizontal[LRUD] = {-1, 1, 0, 0};
-         int moveVertical[LRUD] = {0, 0, -1, 1};
-
-         // If position is correct, add to addingPointerToBPList.
-         for(int j = 0; j < LRUD; ++j) {
-            if(x == checkX + moveHorizontal[j] && y == checkY + moveVertical[j]) {
-               addingPointerToBPList->addBack(new PositionDistance( *(similarDistanceList->get(i)) ) );
+void PathPlanning::traceFieldPath(DistanceField* field, int toX, int toY, PDList* path) {
+
+   // The flood fill keeps no moves, so step to any neighbour that is one closer to the start
+   if(toX >= 0 && toX < cols && toY >= 0 && toY < rows &&
+      field->getDistance(maze->index(toX, toY)) != UNVISITED) {
+
+      int index = maze->index(toX, toY);
+      int distance = field->getDistance(index);
+      path->addBack(toX, toY, distance);
+
+      while(distance != 0) {
+         int next = index;
+         for(int i = 0; i < LRUD && next == index; ++i) {
+            PLANNER_STATS_ADD(stats, neighbourProbes, 1);
+            if(field->getDistance(index + maze->getMove(i)) == distance - 1) {
+               next = index + maze->getMove(i);
             }
          }
+         index = next;
+         distance--;
+
+         path->addBack(maze->getX(index), maze->getY(index), distance);
       }
+   }
+}
 
-      // Add Position Distance from addingPointerToBPList to bestPathList.
-      bestPathList->addBack(new PositionDistance( *(addingPointerToBPList->get(0)) ) );
+void PathPlanning::tracePath(int toX, int toY, PDList* path) {
 
-      delete similarDistanceList;
-      delete addingPointerToBPList;
+   int index = maze->index(toX, toY);
 
-      // Incrementing the coordinate to be checked in bestPathList by 1.
-      indexOfCoorToCheckInBPList++;
-   }
+   // The goal can only be found if the flood fill reached it
+   // Otherwise there is no path, and the list is left empty
+   if(toX >= 0 && toX < cols && toY >= 0 && toY < rows && distanceGrid[index] != UNVISITED) {
 
-   // This is used to help get outputs when creating unit tests
-   // It displays the(x,y,distance)
-   // for(int i = bestPathList->size() - 1; i >= 0; i = i - 1) {
-   //    std::cout << "(" << bestPathList->get(i)->getX() << "," << bestPathList->get(i)->getY() << "," << bestPathList->get(i)->getDistance() << ")" << std::endl; 
-   // }
+      // Add end position to the path
+      int distance = distanceGrid[index];
+      path->addBack(toX, toY, distance);
+
+      // Undo the stored moves one by one until the initial position (distance 0) is added
+      while(distance != 0) {
+         index -= maze->getMove(parentGrid->get(index));
+         distance--;
 
-   return bestPathList;
+         path->addBack(maze->getX(index), maze->getY(index), distance);
+      }
+   }
 }
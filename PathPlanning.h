@@ -1,12 +1,48 @@
 #ifndef COSC_ASS_ONE_PATH_PLANNING
 #define COSC_ASS_ONE_PATH_PLANNING
 
-#define LRUD 4
+// Value stored in the distance grid for a cell that has not been reached
+#define UNVISITED -1
 
+// The search used to answer a path query
+//    ENGINE_FLOOD floods the whole reachable region, then traces back from the goal
+//    ENGINE_ASTAR searches from the start towards the goal only, see AStarSearch.h
+//    ENGINE_BIDIRECTIONAL searches from the start and the goal until they meet, see BidirectionalSearch.h
+//    ENGINE_JPS is A* that jumps over the cells of open areas, see JumpPointSearch.h
+//    ENGINE_BITBOARD floods the whole reachable region a level at a time on bitboards, see BitboardFlood.h
+//    ENGINE_PARALLEL floods the whole reachable region a level at a time on several threads, see ParallelFlood.h
+//    ENGINE_HIERARCHICAL searches a graph of the maze's clusters built on first use, see HierarchicalSearch.h
+//       Its path may be a few cells longer than a shortest path.
+enum SearchEngine {
+   ENGINE_FLOOD,
+   ENGINE_ASTAR,
+   ENGINE_BIDIRECTIONAL,
+   ENGINE_JPS,
+   ENGINE_BITBOARD,
+   ENGINE_PARALLEL,
+   ENGINE_HIERARCHICAL
+};
+
+#include "AStarSearch.h"
+#include "BidirectionalSearch.h"
+#include "BitboardFlood.h"
+#include "DirectionGrid.h"
+#include "HierarchicalSearch.h"
+#include "JumpPointSearch.h"
+#include "LandmarkIndex.h"
+#include "ParallelFlood.h"
+#include "Maze.h"
+#include "MultiSourceFlood.h"
 #include "PositionDistance.h"
+#include "PDArray.h"
 #include "PDList.h"
+#include "PlannerStats.h"
 #include "Types.h"
 
+#include <vector>
+
+// A PathPlanning keeps the state of its last query, so only one thread can use it at a time
+//    See SharedPlanner.h for a planner many threads can query at once.
 class PathPlanning {
 public:
 
@@ -40,10 +76,108 @@ public:
    /* YOU MAY ADD YOUR MODIFICATIONS HERE       */
    /*                                           */
 
+   // Plan on a maze that belongs to someone else, for example the Maze of a MazeFile
+   //    Nothing is copied and the maze is not deleted, so it must outlive the PathPlanning
+   PathPlanning(Maze* maze);
+
+   // Get the paths from the starting position to every position in goals
+   //    The distance field is only computed once for the starting position,
+   //    and is kept until the starting position changes.
+   //    Each path is a DEEP COPY in the same format as getPath, and is owned by the caller.
+   //    A goal that cannot be reached gets an empty path.
+   std::vector<PDList*> getPaths(PDList* goals);
+
+   // Get the path from the starting position to the given co-ordinate using the given search
+   //    The path is a DEEP COPY in the same format as getPath(toX, toY)
+   //    All engines except ENGINE_HIERARCHICAL give a shortest path, but when there is more than one they may pick a different one
+   PDList* getPath(int toX, int toY, SearchEngine engine);
+
+   // Get the reachable positions using the given flood fill
+   //    The list is a DEEP COPY in the same format as getReachablePositions(),
+   //    but the positions with the same distance may be in a different order.
+   //    Only ENGINE_FLOOD, ENGINE_BITBOARD and ENGINE_PARALLEL flood the maze,
+   //    the other engines use ENGINE_FLOOD.
+   PDList* getReachablePositions(SearchEngine engine);
+
+   // Number of cells the last query expanded
+   //    For ENGINE_FLOOD, ENGINE_BITBOARD and ENGINE_PARALLEL this is every reachable cell
+   int getNodesExpanded();
+
+   // Number of threads used by ENGINE_PARALLEL, including the calling thread
+   //    The default is the number of cores. The threads are started the next time ENGINE_PARALLEL is used.
+   void setFloodThreads(int numThreads);
+
+   // Width and height of the clusters of ENGINE_HIERARCHICAL, HPA_CLUSTER_SIZE by default
+   //    Bigger clusters make a smaller graph, but each query floods bigger clusters.
+   //    The graph is built again, with the flood threads, the next time ENGINE_HIERARCHICAL is used.
+   void setClusterSize(int size);
+
+   // Use the given landmarks for the ENGINE_ASTAR heuristic, or stop using them with NULL
+   //    The index is not owned by the PathPlanning, and can be built once and mapped
+   //    from a file (see LandmarkIndex.h). setCell stops using it, as the maze no longer matches it.
+   //    Returns false and uses no landmarks if the index was built for a different maze.
+   bool setLandmarks(LandmarkIndex* landmarks);
+
+   // Get the distance from every reachable position to the nearest of the given sources,
+   //    for example the robots of a fleet or the exits of the maze.
+   //    One flood fill is run from all the sources at once, it does not use the initial position.
+   //    The list is a DEEP COPY in the same format as getReachablePositions(), without the sources.
+   //    owners gets one entry for every position in the list, the position in sources of its nearest source.
+   PDList* getNearestSources(PDList* sources, std::vector<int>& owners);
+
+   // Change the cell at (x,y) of the maze, for example to '=' when a pallet is dropped
+   //    or to '.' when a door opens.
+   //    The distance field of the initial position is repaired where the change reaches,
+   //    instead of being computed again: opening a cell spreads the shorter distances out
+   //    from it, and closing one only recomputes the cells that were reached through it.
+   //    Returns false and changes nothing if (x,y) is outside the maze.
+   bool setCell(int x, int y, char cell);
+
+   // What the queries did: nodes expanded, neighbours probed, allocations, the time of each phase
+   //    and the bytes held by the lists, see PlannerStats.h. getStats().writeJson(out) writes it as JSON.
+   //    Every counter stays 0 unless the program was compiled with -DPATH_PLANNING_STATS.
+   PlannerStats& getStats();
+
 private:
 
-   // The maze copy
-   Grid maze;
+   // Set up everything except the maze, which must already be set
+   void init();
+
+   // Run the flood fill from the initial position, unless the distance field
+   //    in distanceGrid, parentGrid and dotList is already for that position
+   void updateDistanceField();
+
+   // The same as updateDistanceField, for ENGINE_BITBOARD or ENGINE_PARALLEL
+   //    Returns the flood fill of that engine
+   DistanceField* updateLevelField(SearchEngine engine);
+
+   // Add the path from the goal back to the initial position to the given list
+   //    Uses the distance field, so updateDistanceField must be called first
+   void tracePath(int toX, int toY, PDList* path);
+
+   // Repair the distance field after the cell at the given index was opened or closed
+   void repairOpened(int index);
+   void repairClosed(int index);
+
+   // Put the reached cells back into dotList in order of distance, after the distance field was repaired
+   void rebuildDotList();
+
+   // The same as tracePath, using the distances of a flood fill that keeps no moves
+   void traceFieldPath(DistanceField* field, int toX, int toY, PDList* path);
+
+   // The reachable positions from ENGINE_FLOOD, the same as getReachablePositions()
+   //    but not counted as a query of its own
+   PDList* copyReachable();
+
+   // Record the bytes held after a query and finish it, see PlannerStats.h
+   //    reachable is the list handed back by getReachablePositions, or NULL
+   void finishStats(PDList* reachable);
+
+   // The maze copy, stored as one block with a wall border
+   Maze* maze;
+
+   // Checks if the maze is a copy made by the PathPlanning, and has to be deleted
+   bool ownsMaze;
 
    // Number of rows in the maze
    int rows;
@@ -54,21 +188,82 @@ private:
    // The robot's initial position
    PDPtr robotInitialPosition;
 
+   // Distance of every cell from the initial position, stored at the cell's maze index
+   // A cell that has not been reached yet holds UNVISITED
+   // This replaces searching dotList to find out if a position has already been added
+   int* distanceGrid;
+
+   // The move that first reached every cell, 2 bits per cell
+   // getPath follows these moves backwards from the goal to the initial position
+   DirectionGrid* parentGrid;
+
+   // Maze index of the initial position the distance field was computed from
+   // UNVISITED if no distance field has been computed yet
+   int fieldStartIndex;
+
+   // Number of cells in the distance field, including the initial position
+   int reachedCount;
+
+   // Checks if the distance field was repaired since dotList was filled in
+   bool dotListStale;
+
+   // The A* search, created the first time it is used
+   AStarSearch* aStar;
+
+   // The landmarks of the A* search, or NULL
+   LandmarkIndex* landmarks;
+
+   // The bidirectional search, created the first time it is used
+   BidirectionalSearch* bidirectional;
+
+   // The jump point search, created the first time it is used
+   JumpPointSearch* jumpPoint;
+
+   // The bitboard flood fill, created the first time it is used
+   BitboardFlood* bitboard;
+
+   // Maze index of the initial position the bitboard flood fill was run from
+   int bitboardStartIndex;
+
+   // The multi-threaded flood fill, created the first time it is used
+   ParallelFlood* parallel;
+
+   // Maze index of the initial position the multi-threaded flood fill was run from
+   int parallelStartIndex;
+
+   // Number of threads for the multi-threaded flood fill
+   int floodThreads;
+
+   // The hierarchical search, its graph is built the first time it is used
+   HierarchicalSearch* hierarchical;
+
+   // Width and height of the clusters of the hierarchical search
+   int clusterSize;
+
+   // The flood fill from several sources, created the first time it is used
+   MultiSourceFlood* multiSource;
+
+   // Number of cells the last getPath query expanded
+   int nodesExpanded;
+
+   // Where the positions of bestPathList are made
+   // It is emptied every time a path is found
+   PDArena* pathArena;
+
    // A list that contains all '.' in the maze.
    // Basically, this list contains all reachable positions, including the initial position
    // This list is used in both milestone 2 and milestone 3
-   PDList* dotList;
-
-   // A list that contains all '.' in the maze except where the robot is at
-   // Basically, this list contains all reachable positions except the initial position
-   // It should only have the positions where the robot can go
-   // This list is used in milestone 2
-   PDList* reachableList;
+   // It is a PDArray, so the flood fill reads the positions straight from memory instead of through pointers
+   // The positions after the first one are the reachable positions of milestone 2
+   PDArray* dotList;
 
    // This list that should only contain positions that are the best path scenario the robot should take
    // This list is used in milestone 3, and is also the list that will be returned in the functional prototype
    // This list is known as list A as created in algorithm
    PDList* bestPathList;
+
+   // What the queries did, only counted with PATH_PLANNING_STATS
+   PlannerStats stats;
 };
 
 #endif // COSC_ASS_ONE_PATH_PLANNING
@@ -0,0 +1,113 @@
+#include "PlannerStats.h"
+
+#include <cstdlib>
+#include <new>
+
+// Counters of the thread running the code, every thread has its own
+//    Only PATH_PLANNING_STATS builds add to them
+static thread_local long threadAllocations = 0;
+static thread_local long threadAllocatedBytes = 0;
+static thread_local long threadComparisons = 0;
+
+#ifdef PATH_PLANNING_STATS
+
+// Every new and new[] of the program comes through here, and is counted before the memory is got
+//    The other forms of new (nothrow, new[]) call this one, delete is only replaced to match it
+void* operator new(std::size_t bytes) {
+   threadAllocations++;
+   threadAllocatedBytes += bytes;
+
+   void* memory = std::malloc(bytes == 0 ? 1 : bytes);
+   if(memory == nullptr) {
+      throw std::bad_alloc();
+   }
+   return memory;
+}
+
+void operator delete(void* memory) noexcept {
+   std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+   std::free(memory);
+}
+
+#endif // PATH_PLANNING_STATS
+
+PlannerStats::PlannerStats() {
+   reset();
+}
+
+bool PlannerStats::enabled() {
+#ifdef PATH_PLANNING_STATS
+   return true;
+#else
+   return false;
+#endif
+}
+
+void PlannerStats::reset() {
+   last = Counters();
+   total = Counters();
+   queries = 0;
+   fieldBytes = 0;
+   dotListBytes = 0;
+   bestPathListBytes = 0;
+   reachableListBytes = 0;
+   allocationsAtBegin = 0;
+   allocatedBytesAtBegin = 0;
+   comparisonsAtBegin = 0;
+}
+
+void PlannerStats::beginQuery() {
+   last = Counters();
+   allocationsAtBegin = threadAllocations;
+   allocatedBytesAtBegin = threadAllocatedBytes;
+   comparisonsAtBegin = threadComparisons;
+}
+
+void PlannerStats::endQuery() {
+   last.allocations += threadAllocations - allocationsAtBegin;
+   last.allocatedBytes += threadAllocatedBytes - allocatedBytesAtBegin;
+   last.comparisons += threadComparisons - comparisonsAtBegin;
+
+   total.nodesExpanded += last.nodesExpanded;
+   total.neighbourProbes += last.neighbourProbes;
+   total.comparisons += last.comparisons;
+   total.allocations += last.allocations;
+   total.allocatedBytes += last.allocatedBytes;
+   total.floodNanos += last.floodNanos;
+   total.traceNanos += last.traceNanos;
+   total.copyNanos += last.copyNanos;
+   queries++;
+}
+
+void PlannerStats::countComparisons(long comparisons) {
+   threadComparisons += comparisons;
+}
+
+void PlannerStats::writeCounters(std::ostream& out, Counters& counters) {
+   out << "{\"nodes_expanded\": " << counters.nodesExpanded
+       << ", \"neighbour_probes\": " << counters.neighbourProbes
+       << ", \"comparisons\": " << counters.comparisons
+       << ", \"allocations\": " << counters.allocations
+       << ", \"allocated_bytes\": " << counters.allocatedBytes
+       << ", \"flood_ns\": " << counters.floodNanos
+       << ", \"trace_ns\": " << counters.traceNanos
+       << ", \"copy_ns\": " << counters.copyNanos
+       << "}";
+}
+
+void PlannerStats::writeJson(std::ostream& out) {
+   out << "{\"enabled\": " << (enabled() ? "true" : "false")
+       << ", \"queries\": " << queries
+       << ", \"last\": ";
+   writeCounters(out, last);
+   out << ", \"total\": ";
+   writeCounters(out, total);
+   out << ", \"bytes\": {\"field\": " << fieldBytes
+       << ", \"dot_list\": " << dotListBytes
+       << ", \"best_path_list\": " << bestPathListBytes
+       << ", \"reachable_list\": " << reachableListBytes
+       << "}}";
+}
@@ -0,0 +1,116 @@
+#ifndef COSC_ASS_ONE_PLANNER_STATS
+#define COSC_ASS_ONE_PLANNER_STATS
+
+#include <chrono>
+#include <ostream>
+
+// What the queries of a PathPlanning did, to find out why a query is slow.
+//    The counters are only kept when the program is compiled with -DPATH_PLANNING_STATS,
+//    for example make STATS=1 (see Makefile)
+//    PathPlanning counts them with the PLANNER_STATS_ lines at the bottom: PLANNER_STATS_START starts a
+//    timer and PLANNER_STATS_LAP adds the time since then to a phase and starts it again.
+//    Without it, every PLANNER_STATS_ line compiles to nothing, so the searches are the same
+//    code as before and every counter stays 0.
+//    With it, every allocation made with new is also counted, on the thread that made it (see PlannerStats.cpp).
+//
+//    Every call of getPath, getPaths, getReachablePositions, getNearestSources and setCell is one query.
+//    The time of a query is split into three phases:
+//       flood, the flood fill or search (or the repair of the distance field for setCell),
+//       trace, following the path back from the goal,
+//       copy, making the list handed back to the caller.
+//    The searches that run in their own class (ENGINE_ASTAR, ENGINE_BIDIRECTIONAL, ENGINE_JPS and
+//    ENGINE_HIERARCHICAL) find the path as they search, so all of their time is flood time,
+//    and only the nodes they expand are counted, not their neighbour probes.
+struct PlannerStats {
+
+   // The counters of one query, or of many added together
+   struct Counters {
+
+      // Cells taken off the queue of a flood fill or search
+      long nodesExpanded;
+
+      // Neighbours of an expanded cell that were checked
+      long neighbourProbes;
+
+      // Positions compared by PDList::containsCoordinate
+      long comparisons;
+
+      // Calls to new, and the bytes they asked for
+      long allocations;
+      long allocatedBytes;
+
+      // Time spent in each phase, in nanoseconds
+      long floodNanos;
+      long traceNanos;
+      long copyNanos;
+   };
+
+   // The last query
+   Counters last;
+
+   // Every query since the stats were reset
+   Counters total;
+
+   // Number of queries since the stats were reset
+   long queries;
+
+   // Bytes held by the PathPlanning after the last query
+   //    fieldBytes is the distance grid and the moves of the flood fill,
+   //    reachableBytes is the last list handed back by getReachablePositions
+   long fieldBytes;
+   long dotListBytes;
+   long bestPathListBytes;
+   long reachableListBytes;
+
+   // Start with every counter at 0
+   PlannerStats();
+
+   // Checks if the program was compiled with PATH_PLANNING_STATS
+   static bool enabled();
+
+   // Set every counter back to 0
+   void reset();
+
+   // Start a query, last is set to 0
+   void beginQuery();
+
+   // Finish a query, the allocations and comparisons made since beginQuery are
+   //    counted in last, and last is added to total
+   void endQuery();
+
+   // Write the stats as one JSON object
+   void writeJson(std::ostream& out);
+
+   // Count comparisons made by PDList::containsCoordinate on this thread
+   static void countComparisons(long comparisons);
+
+private:
+
+   // Counters of this thread when the query began
+   long allocationsAtBegin;
+   long allocatedBytesAtBegin;
+   long comparisonsAtBegin;
+
+   // Write one Counters as a JSON object
+   void writeCounters(std::ostream& out, Counters& counters);
+};
+
+#ifdef PATH_PLANNING_STATS
+#define PLANNER_STATS_RUN(statement) statement
+#define PLANNER_STATS_ADD(stats, counter, amount) ((stats).last.counter += (amount))
+#define PLANNER_STATS_START(timer) \
+   std::chrono::steady_clock::time_point timer = std::chrono::steady_clock::now()
+#define PLANNER_STATS_LAP(stats, counter, timer) \
+   do { \
+      std::chrono::steady_clock::time_point lapEnd = std::chrono::steady_clock::now(); \
+      (stats).last.counter += std::chrono::duration_cast<std::chrono::nanoseconds>(lapEnd - (timer)).count(); \
+      timer = lapEnd; \
+   } while(false)
+#else
+#define PLANNER_STATS_RUN(statement)
+#define PLANNER_STATS_ADD(stats, counter, amount)
+#define PLANNER_STATS_START(timer)
+#define PLANNER_STATS_LAP(stats, counter, timer)
+#endif
+
+#endif // COSC_ASS_ONE_PLANNER_STATS
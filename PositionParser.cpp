@@ -0,0 +1,113 @@
+#include "PositionParser.h"
+
+#include <climits>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+PositionParser::PositionParser(const char* text, size_t length, int numbers) {
+   at = text;
+   end = text + length;
+   mapped = nullptr;
+   mappedBytes = 0;
+   this->numbers = numbers;
+   line = 1;
+   positionLine = 0;
+}
+
+PositionParser::PositionParser(std::string filename, int numbers) {
+   mapped = nullptr;
+   mappedBytes = 0;
+   this->numbers = numbers;
+   line = 1;
+   positionLine = 0;
+
+   int fd = open(filename.c_str(), O_RDONLY);
+   if(fd < 0) {
+      throw std::runtime_error("Could not open file '" + filename + "'");
+   }
+
+   // An empty file cannot be mapped, it just has no positions
+   struct stat info;
+   if(fstat(fd, &info) == 0 && info.st_size > 0) {
+      void* region = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(region == MAP_FAILED) {
+         close(fd);
+         throw std::runtime_error("Could not map file '" + filename + "'");
+      }
+      mapped = (char*) region;
+      mappedBytes = info.st_size;
+   }
+   close(fd);
+
+   at = mapped;
+   end = mapped + mappedBytes;
+}
+
+PositionParser::~PositionParser() {
+   if(mapped != nullptr) {
+      munmap(mapped, mappedBytes);
+   }
+   mapped = nullptr;
+}
+
+int PositionParser::getLine() {
+   return positionLine;
+}
+
+void PositionParser::fail() {
+   throw std::runtime_error("Position format incorrect on line " + std::to_string(line));
+}
+
+bool PositionParser::readNumber(int& number) {
+   bool ok = at != end && *at >= '0' && *at <= '9';
+   long value = 0;
+
+   while(ok && at != end && *at >= '0' && *at <= '9') {
+      value = value * 10 + (*at - '0');
+      ok = value <= INT_MAX;
+      ++at;
+   }
+   number = value;
+
+   return ok;
+}
+
+bool PositionParser::next(int& x, int& y, int& distance) {
+
+   // Skip the spaces and line endings before the position
+   while(at != end && (*at == ' ' || *at == '\t' || *at == '\r' || *at == '\n')) {
+      if(*at == '\n') {
+         line++;
+      }
+      ++at;
+   }
+   if(at == end) {
+      return false;
+   }
+   positionLine = line;
+
+   // (x,y) or (x,y,distance)
+   distance = 0;
+   int* values[POSITION_XYD] = {&x, &y, &distance};
+   bool ok = *at == '(';
+   ++at;
+   for(int i = 0; i < numbers && ok; ++i) {
+      ok = readNumber(*values[i]);
+      if(ok) {
+         char after = i + 1 < numbers ? ',' : ')';
+         ok = at != end && *at == after;
+         ++at;
+      }
+   }
+
+   // The position must end where a space or line ending starts
+   ok = ok && (at == end || *at == ' ' || *at == '\t' || *at == '\r' || *at == '\n');
+   if(!ok) {
+      fail();
+   }
+
+   return true;
+}
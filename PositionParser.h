@@ -0,0 +1,73 @@
+#ifndef COSC_ASS_ONE_POSITION_PARSER
+#define COSC_ASS_ONE_POSITION_PARSER
+
+#include <cstddef>
+#include <string>
+
+// Number of numbers in a position written as (x,y)
+#define POSITION_XY 2
+
+// Number of numbers in a position written as (x,y,distance)
+#define POSITION_XYD 3
+
+// Reads the positions of a .initial, .goal, .pos or .path file.
+//    The positions are separated by spaces or line endings, and each one is
+//    (x,y) or (x,y,distance) with no spaces inside it, the same as the files the tests use.
+//    The text is scanned one character at a time where it is, nothing is copied or allocated,
+//    so it can read a file of millions of positions as fast as the file can be read.
+//    A file is mapped into memory instead of being read.
+class PositionParser {
+public:
+
+   // Read positions from text that is already in memory, length characters long
+   //    The text is not copied, so it must not be deleted before the parser.
+   //    numbers is POSITION_XY or POSITION_XYD, every position must have that many numbers.
+   PositionParser(const char* text, size_t length, int numbers);
+
+   // Read positions from the given file
+   //    Throws std::runtime_error if it cannot be opened or mapped
+   PositionParser(std::string filename, int numbers);
+
+   // Clean-up, unmaps the file
+   ~PositionParser();
+
+   // Read the next position
+   //    distance is set to 0 for a position written as (x,y)
+   //    Returns false if there are no more positions.
+   //    Throws std::runtime_error with the line number if the next position is not written correctly
+   bool next(int& x, int& y, int& distance);
+
+   // Line of the text the last position was read from, the first line is 1
+   int getLine();
+
+   PositionParser(PositionParser& other) = delete;
+   PositionParser& operator=(PositionParser& other) = delete;
+
+private:
+
+   // The text, and one past its last character
+   const char* at;
+   const char* end;
+
+   // The mapped file, or nullptr if the text belongs to someone else
+   char* mapped;
+   size_t mappedBytes;
+
+   // Number of numbers in every position
+   int numbers;
+
+   // Line of the text at is on
+   int line;
+
+   // Line the last position was read from
+   int positionLine;
+
+   // Read a number at at, and move at past it
+   //    Returns false if there is no number there, or it does not fit in an int
+   bool readNumber(int& number);
+
+   // Throw the error for a position that is not written correctly
+   void fail();
+};
+
+#endif // COSC_ASS_ONE_POSITION_PARSER
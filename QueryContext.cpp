@@ -0,0 +1,97 @@
+#include "QueryContext.h"
+
+#include "PathPlanning.h"
+
+QueryContext::QueryContext() {
+   for(PlannerState& state : states) {
+      state.plannerId = -1;
+      state.lastUsed = 0;
+      state.numCells = 0;
+      state.distanceGrid = NULL;
+      state.parentGrid = NULL;
+      state.fieldStartIndex = UNVISITED;
+      state.aStar = NULL;
+      state.bidirectional = NULL;
+      state.jumpPoint = NULL;
+   }
+   numQueries = 0;
+   nodesExpanded = 0;
+}
+
+QueryContext::~QueryContext() {
+   for(PlannerState& state : states) {
+      clearState(&state);
+   }
+}
+
+QueryContext::PlannerState* QueryContext::findState(long plannerId) {
+   PlannerState* found = NULL;
+   PlannerState* oldest = &states[0];
+
+   for(PlannerState& state : states) {
+      if(state.plannerId == plannerId) {
+         found = &state;
+      } else if(state.lastUsed < oldest->lastUsed) {
+         oldest = &state;
+      }
+   }
+
+   if(found == NULL) {
+      found = oldest;
+      clearState(found);
+      found->plannerId = plannerId;
+   }
+   numQueries++;
+   found->lastUsed = numQueries;
+
+   return found;
+}
+
+void QueryContext::clear() {
+   for(PlannerState& state : states) {
+      clearState(&state);
+   }
+}
+
+void QueryContext::release(long plannerId) {
+   for(PlannerState& state : states) {
+      if(state.plannerId == plannerId) {
+         clearState(&state);
+      }
+   }
+}
+
+long QueryContext::bytes() {
+   long total = 0;
+
+   for(PlannerState& state : states) {
+      if(state.distanceGrid != NULL) {
+         total += (long) state.numCells * sizeof(int) + state.parentGrid->bytes();
+      }
+      total += (long) state.reached.capacity() * sizeof(int);
+   }
+
+   return total;
+}
+
+void QueryContext::clearState(PlannerState* state) {
+   delete[] state->distanceGrid;
+   state->distanceGrid = NULL;
+   delete state->parentGrid;
+   state->parentGrid = NULL;
+   delete state->aStar;
+   state->aStar = NULL;
+   delete state->bidirectional;
+   state->bidirectional = NULL;
+   delete state->jumpPoint;
+   state->jumpPoint = NULL;
+
+   std::vector<int>().swap(state->reached);
+   state->numCells = 0;
+   state->fieldStartIndex = UNVISITED;
+   state->plannerId = -1;
+}
+
+int QueryContext::getNodesExpanded() {
+   return nodesExpanded;
+}
@@ -0,0 +1,106 @@
+#ifndef COSC_ASS_ONE_QUERY_CONTEXT
+#define COSC_ASS_ONE_QUERY_CONTEXT
+
+#include "AStarSearch.h"
+#include "BidirectionalSearch.h"
+#include "DirectionGrid.h"
+#include "JumpPointSearch.h"
+
+#include <vector>
+
+// Number of planners a context keeps the search state of at once
+#define QUERY_CONTEXT_PLANNERS 4
+
+// Everything a query of a SharedPlanner writes while it searches.
+//    A SharedPlanner never changes after it is set up, so the threads that query it
+//    each keep a context of their own and no query has to wait for another.
+//    A context can be used with any SharedPlanner: the first time it is used with one,
+//    it sets up search state the right size for that planner's maze. It keeps the state of
+//    the last QUERY_CONTEXT_PLANNERS planners it was used with, so a thread that serves a few
+//    mazes does not set up a maze again every time it moves between them. With more planners
+//    than that, the one used longest ago is dropped, so a thread serving many mazes
+//    should keep a context for each of them.
+//    The flood fill from the last start for each planner is kept, so more paths from
+//    the same start only have to be traced.
+//    The state for a planner is kept until it is dropped, the context is cleared or deleted,
+//    or the planner is deleted on the thread whose context it is (see ~SharedPlanner).
+//    A context must only be used by one thread at a time.
+class QueryContext {
+public:
+
+   // Create an empty context, nothing is allocated until it is first used
+   QueryContext();
+
+   // Clean-up
+   ~QueryContext();
+
+   // Number of cells the last query made with this context expanded
+   int getNodesExpanded();
+
+   // Free the search state of every planner, the context can still be used afterwards
+   void clear();
+
+   // Number of bytes held by the distance fields, parent moves and reached cells of every planner
+   //    The A*, bidirectional and JPS searches are not counted.
+   long bytes();
+
+   QueryContext(QueryContext& other) = delete;
+   QueryContext& operator=(QueryContext& other) = delete;
+
+private:
+
+   // Only the planner reads and writes the search state
+   friend class SharedPlanner;
+
+   // The search state for one planner
+   struct PlannerState {
+
+      // Id of the SharedPlanner the state was set up for, -1 if none
+      long plannerId;
+
+      // The last query that used the state, the state used longest ago is the one dropped
+      long lastUsed;
+
+      // Number of cells in the maze of the planner, including the border, 0 until it is set up
+      int numCells;
+
+      // Distance of every cell of the maze from the start of the flood fill, UNVISITED if not reached
+      // It uses the same indexes as the maze, including the border
+      int* distanceGrid;
+
+      // The move that first reached every cell
+      DirectionGrid* parentGrid;
+
+      // The cells reached by the flood fill in order of distance, the start is the first one
+      std::vector<int> reached;
+
+      // Maze index of the start of the flood fill, UNVISITED if there is none
+      int fieldStartIndex;
+
+      // The searches of the other engines, created the first time they are used
+      AStarSearch* aStar;
+      BidirectionalSearch* bidirectional;
+      JumpPointSearch* jumpPoint;
+   };
+
+   // The state of the planners used last
+   PlannerState states[QUERY_CONTEXT_PLANNERS];
+
+   // Number of queries made with the context
+   long numQueries;
+
+   // Number of cells the last query expanded
+   int nodesExpanded;
+
+   // The state for the given planner, taking over the one used longest ago if there is none yet
+   //    A state that is taken over is cleared, the planner then sets it up for its maze.
+   PlannerState* findState(long plannerId);
+
+   // Free the state for the given planner, if the context has one
+   void release(long plannerId);
+
+   // Free everything a state was set up with
+   static void clearState(PlannerState* state);
+};
+
+#endif // COSC_ASS_ONE_QUERY_CONTEXT
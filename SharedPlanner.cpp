@@ -0,0 +1,215 @@
+#include "SharedPlanner.h"
+
+#include <algorithm>
+#include <atomic>
+
+// Id of the next SharedPlanner made
+static std::atomic<long> nextPlannerId(0);
+
+// Checks if the calling thread's context has been made and not yet deleted
+// A plain bool, so it can still be read while the thread's other objects are being deleted
+static thread_local bool threadContextLive = false;
+
+// The context of a thread, which says when it is made and deleted
+struct ThreadContext {
+   QueryContext context;
+
+   ThreadContext() {
+      threadContextLive = true;
+   }
+
+   ~ThreadContext() {
+      threadContextLive = false;
+   }
+};
+
+SharedPlanner::SharedPlanner(Grid originalMaze, int rows, int cols) {
+
+   // The same copy as PathPlanning makes, a negative size is an empty maze
+   maze = new Maze(originalMaze, std::max(rows, 0), std::max(cols, 0));
+   ownsMaze = true;
+   landmarks = NULL;
+   id = nextPlannerId++;
+
+   // The grid that was passed in is deleted, only if its size makes sense
+   if(rows >= 0 && cols >= 0) {
+      for (int i = 0; i < rows; ++i) {
+         delete[] originalMaze[i];
+         originalMaze[i] = nullptr;
+      }
+      delete[] originalMaze;
+   }
+}
+
+SharedPlanner::SharedPlanner(Maze* maze) {
+   this->maze = maze;
+   ownsMaze = false;
+   landmarks = NULL;
+   id = nextPlannerId++;
+}
+
+SharedPlanner::~SharedPlanner() {
+
+   // Only this thread's context can be reached safely, the others may be in use
+   if(threadContextLive) {
+      getThreadContext()->release(id);
+   }
+
+   if(ownsMaze) {
+      delete maze;
+   }
+   maze = nullptr;
+}
+
+bool SharedPlanner::setLandmarks(LandmarkIndex* landmarks) {
+   bool matches = landmarks == NULL || landmarks->matches(maze);
+   this->landmarks = matches ? landmarks : NULL;
+   return matches;
+}
+
+Maze* SharedPlanner::getMaze() const {
+   return maze;
+}
+
+bool SharedPlanner::inside(int x, int y) const {
+   return x >= 0 && x < maze->getCols() && y >= 0 && y < maze->getRows();
+}
+
+QueryContext::PlannerState* SharedPlanner::prepare(QueryContext* context) const {
+   QueryContext::PlannerState* state = context->findState(id);
+
+   // A new state is allocated for this planner's maze, which may be a different size to the last one
+   if(state->distanceGrid == NULL) {
+      state->numCells = maze->size();
+      state->distanceGrid = new int[maze->size()];
+      state->parentGrid = new DirectionGrid(maze->size());
+   }
+
+   return state;
+}
+
+void SharedPlanner::flood(QueryContext* context, QueryContext::PlannerState* state, int startIndex) const {
+
+   // The flood fill from this start is still in the state
+   if(startIndex == state->fieldStartIndex) {
+      context->nodesExpanded = state->reached.size();
+      return;
+   }
+   state->fieldStartIndex = startIndex;
+
+   int* distanceGrid = state->distanceGrid;
+   std::vector<int>& reached = state->reached;
+   for(int i = 0; i < maze->size(); ++i) {
+      distanceGrid[i] = UNVISITED;
+   }
+
+   // The same flood fill as PathPlanning, so the positions come out in the same order
+   reached.clear();
+   reached.push_back(startIndex);
+   distanceGrid[startIndex] = 0;
+   for(unsigned int head = 0; head < reached.size(); ++head) {
+      int current = reached[head];
+      for(int i = 0; i < LRUD; ++i) {
+         int next = current + maze->getMove(i);
+         if(distanceGrid[next] == UNVISITED && maze->isOpen(next)) {
+            distanceGrid[next] = distanceGrid[current] + 1;
+            state->parentGrid->set(next, i);
+            reached.push_back(next);
+         }
+      }
+   }
+   context->nodesExpanded = reached.size();
+}
+
+PDList* SharedPlanner::getReachablePositions(QueryContext* context, int x, int y) const {
+   QueryContext::PlannerState* state = prepare(context);
+   PDList* reachable = NULL;
+
+   if(inside(x, y)) {
+      flood(context, state, maze->index(x, y));
+
+      // Every reached cell except the start (the first one) is reachable
+      std::vector<int>& reached = state->reached;
+      reachable = new PDList(new PDArena(reached.size()), true);
+      for(unsigned int i = 1; i < reached.size(); ++i) {
+         reachable->addBack(maze->getX(reached[i]), maze->getY(reached[i]),
+                            state->distanceGrid[reached[i]]);
+      }
+   } else {
+      reachable = new PDList(new PDArena(), true);
+      context->nodesExpanded = 0;
+   }
+
+   return reachable;
+}
+
+PDList* SharedPlanner::getPath(QueryContext* context, int fromX, int fromY, int toX, int toY,
+                               SearchEngine engine) const {
+   QueryContext::PlannerState* state = prepare(context);
+   PDList* path = new PDList(new PDArena(), true);
+   context->nodesExpanded = 0;
+
+   if(inside(fromX, fromY) && inside(toX, toY)) {
+      switch(engine) {
+         case ENGINE_ASTAR:
+            if(state->aStar == NULL) {
+               state->aStar = new AStarSearch(maze);
+            }
+            state->aStar->setLandmarks(landmarks);
+            state->aStar->findPath(fromX, fromY, toX, toY, path);
+            context->nodesExpanded = state->aStar->getNodesExpanded();
+            break;
+
+         case ENGINE_BIDIRECTIONAL:
+            if(state->bidirectional == NULL) {
+               state->bidirectional = new BidirectionalSearch(maze);
+            }
+            state->bidirectional->findPath(fromX, fromY, toX, toY, path);
+            context->nodesExpanded = state->bidirectional->getNodesExpanded();
+            break;
+
+         case ENGINE_JPS:
+            if(state->jumpPoint == NULL) {
+               state->jumpPoint = new JumpPointSearch(maze);
+            }
+            state->jumpPoint->findPath(fromX, fromY, toX, toY, path);
+            context->nodesExpanded = state->jumpPoint->getNodesExpanded();
+            break;
+
+         case ENGINE_FLOOD:
+         default: {
+            flood(context, state, maze->index(fromX, fromY));
+
+            // Undo the stored moves from the goal back to the start, the same as PathPlanning::tracePath
+            int index = maze->index(toX, toY);
+            int distance = state->distanceGrid[index];
+            if(distance != UNVISITED) {
+               path->addBack(toX, toY, distance);
+               while(distance != 0) {
+                  index -= maze->getMove(state->parentGrid->get(index));
+                  distance--;
+                  path->addBack(maze->getX(index), maze->getY(index), distance);
+               }
+            }
+            break;
+         }
+      }
+   }
+
+   return path;
+}
+
+QueryContext* SharedPlanner::getThreadContext() {
+
+   // Every thread has its own context, made the first time the thread asks for it
+   static thread_local ThreadContext threadContext;
+   return &threadContext.context;
+}
+
+PDList* SharedPlanner::getReachablePositions(int x, int y) const {
+   return getReachablePositions(getThreadContext(), x, y);
+}
+
+PDList* SharedPlanner::getPath(int fromX, int fromY, int toX, int toY, SearchEngine engine) const {
+   return getPath(getThreadContext(), fromX, fromY, toX, toY, engine);
+}
@@ -0,0 +1,98 @@
+#ifndef COSC_ASS_ONE_SHARED_PLANNER
+#define COSC_ASS_ONE_SHARED_PLANNER
+
+#include "LandmarkIndex.h"
+#include "Maze.h"
+#include "PathPlanning.h"
+#include "PDList.h"
+#include "QueryContext.h"
+#include "Types.h"
+
+// A planner that many threads can query at the same time.
+//    PathPlanning keeps the state of its last query (the initial position, the distance
+//    field and the last path) in itself, so only one thread can use it.
+//    A SharedPlanner only holds the maze and the landmarks, which its queries never change,
+//    and every query is const: it gets its start with it, and writes its search state to
+//    the QueryContext it is given. N threads with a context each can then query one planner
+//    with no locks, and each context keeps its own flood fill from its last start.
+//    The queries without a context share one that belongs to the calling thread, see QueryContext.h
+//    for how many planners it keeps the state of at once.
+//    The answers are the same as PathPlanning's, and are owned by the caller.
+class SharedPlanner {
+public:
+
+   // Plan on a copy of the given maze of size (x,y), the grid is deleted the same way PathPlanning does
+   //    A negative size gives an empty maze, and the grid is then not deleted, the same as PathPlanning.
+   SharedPlanner(Grid maze, int rows, int cols);
+
+   // Plan on a maze that belongs to someone else, for example the Maze of a MazeFile
+   //    Nothing is copied and the maze is not deleted, so it must outlive the planner
+   //    and must not be changed while queries are made.
+   SharedPlanner(Maze* maze);
+
+   // Clean-up
+   //    The state the calling thread's context holds for this planner is freed.
+   //    The contexts of other threads, and contexts the caller made, keep the planner's state
+   //    (a whole distance field for its maze) until they are used with QUERY_CONTEXT_PLANNERS
+   //    other planners, or are cleared or deleted. A thread that outlives many planners can
+   //    free everything its context holds with getThreadContext()->clear().
+   //    A context that was used with this planner can still be used with another one.
+   ~SharedPlanner();
+
+   // Use the given landmarks for the ENGINE_ASTAR heuristic, or stop using them with NULL
+   //    Only call this before the threads start making queries, it is the one thing that changes the planner.
+   //    Returns false and uses no landmarks if the index was built for a different maze.
+   bool setLandmarks(LandmarkIndex* landmarks);
+
+   // Get the reachable positions from (x,y), the same as PathPlanning::getReachablePositions
+   //    The list is empty if (x,y) is outside the maze.
+   PDList* getReachablePositions(QueryContext* context, int x, int y) const;
+
+   // Get the path from (fromX,fromY) to (toX,toY), the same as PathPlanning::getPath
+   //    Only ENGINE_FLOOD, ENGINE_ASTAR, ENGINE_BIDIRECTIONAL and ENGINE_JPS keep all of their
+   //    state in the context, the other engines use ENGINE_FLOOD.
+   //    The path is empty if there is none, or a position is outside the maze.
+   PDList* getPath(QueryContext* context, int fromX, int fromY, int toX, int toY,
+                   SearchEngine engine = ENGINE_FLOOD) const;
+
+   // The same queries, with the context of the calling thread
+   //    Both share the one context, so a path from the start of the last reachable positions is only traced.
+   PDList* getReachablePositions(int x, int y) const;
+   PDList* getPath(int fromX, int fromY, int toX, int toY, SearchEngine engine = ENGINE_FLOOD) const;
+
+   // The maze the planner plans on
+   Maze* getMaze() const;
+
+   // The context of the calling thread, used by the queries without a context
+   //    It is made the first time the thread asks for it and deleted when the thread ends.
+   static QueryContext* getThreadContext();
+
+   SharedPlanner(SharedPlanner& other) = delete;
+   SharedPlanner& operator=(SharedPlanner& other) = delete;
+
+private:
+
+   // The maze, stored as one block with a wall border
+   Maze* maze;
+
+   // Checks if the maze is a copy made by the planner, and has to be deleted
+   bool ownsMaze;
+
+   // The landmarks of the A* search, or NULL
+   LandmarkIndex* landmarks;
+
+   // Different for every planner ever made, so a context knows which planner it was set up for
+   long id;
+
+   // The state of the context for this planner, set up for its maze the first time
+   QueryContext::PlannerState* prepare(QueryContext* context) const;
+
+   // Run the flood fill from the given maze index, unless the state already has it
+   void flood(QueryContext* context, QueryContext::PlannerState* state, int startIndex) const;
+
+
+   // Checks if (x,y) is inside the maze
+   bool inside(int x, int y) const;
+};
+
+#endif // COSC_ASS_ONE_SHARED_PLANNER
@@ -0,0 +1,458 @@
+#include "TiledFlood.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <fcntl.h>
+#include <functional>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Marks a cell that has not been reached, the same as PathPlanning's UNVISITED
+#define NOT_REACHED -1
+
+// The edges of a tile {Top, Bottom, Left, Right}
+#define TILE_SIDES 4
+
+// Bytes read at a time while looking for the end of the first line
+#define TILED_READ_BLOCK 4096
+
+// Make a scratch file in the directory and remove its name straight away,
+// so it is deleted when it is closed
+static int make_scratch_file(std::string directory) {
+   std::string name = directory + "/tiledflood-XXXXXX";
+   std::vector<char> path(name.begin(), name.end());
+   path.push_back('\0');
+
+   int file = mkstemp(path.data());
+   if(file < 0) {
+      throw std::runtime_error("Could not make a scratch file in '" + directory + "'");
+   }
+   unlink(path.data());
+   return file;
+}
+
+TiledFlood::TiledFlood(std::string mazeFilename, std::string scratchDirectory,
+                       int tileSize, int maxResidentTiles) {
+   this->tileSize = tileSize < 1 ? 1 : tileSize;
+   this->maxResidentTiles = maxResidentTiles < 1 ? 1 : maxResidentTiles;
+   useCounter = 0;
+   startTile = -1;
+   startCell = 0;
+   stats = TiledStats();
+
+   mazeFile = open(mazeFilename.c_str(), O_RDONLY);
+   if(mazeFile < 0) {
+      throw std::runtime_error("Could not open file '" + mazeFilename + "'");
+   }
+   distanceFile = make_scratch_file(scratchDirectory);
+   edgeFile = make_scratch_file(scratchDirectory);
+
+   struct stat info;
+   fstat(mazeFile, &info);
+   long fileBytes = info.st_size;
+
+   // Line endings at the end of the file do not count as rows
+   long textBytes = fileBytes;
+   char last = '\n';
+   while(textBytes > 0 && (last == '\n' || last == '\r')) {
+      readAt(mazeFile, &last, 1, textBytes - 1);
+      if(last == '\n' || last == '\r') {
+         textBytes--;
+      }
+   }
+
+   // The first line gives the width of every row, and the length of a line ending
+   // Only the first line and the last few bytes are read, the rows are not checked
+   long width = 0;
+   bool found = false;
+   char block[TILED_READ_BLOCK];
+   while(!found && width < textBytes) {
+      long bytes = std::min((long) TILED_READ_BLOCK, textBytes - width);
+      readAt(mazeFile, block, bytes, width);
+      for(long i = 0; i < bytes && !found; ++i) {
+         if(block[i] == '\n' || block[i] == '\r') {
+            found = true;
+         } else {
+            width++;
+         }
+      }
+   }
+   stride = width;
+   char ending = '\r';
+   while(ending == '\r' && stride < fileBytes) {
+      readAt(mazeFile, &ending, 1, stride);
+      if(ending == '\r') {
+         stride++;
+      }
+   }
+   stride++;
+
+   if(width == 0 || (textBytes + stride - width) % stride != 0) {
+      throw std::runtime_error(width == 0 ? "No Maze in file" : "Maze dimensions not consistent");
+   }
+   cols = (int) width;
+   rows = (int) ((textBytes + stride - width) / stride);
+
+   tilesX = (cols + this->tileSize - 1) / this->tileSize;
+   tilesY = (rows + this->tileSize - 1) / this->tileSize;
+   flooded.assign((long) tilesX * tilesY, 0);
+   pending.assign((long) tilesX * tilesY, INT_MAX);
+   stats.tileInfoBytes = (long) tilesX * tilesY * (sizeof(char) + sizeof(int));
+
+   // Tiles are handed out by reference, so the vector must never move them
+   resident.reserve(this->maxResidentTiles);
+   oldEdges.resize(TILE_SIDES * this->tileSize);
+   edges.resize(TILE_SIDES * this->tileSize);
+}
+
+TiledFlood::~TiledFlood() {
+   for(Tile& tile : resident) {
+      delete[] tile.cells;
+      delete[] tile.distances;
+   }
+   resident.clear();
+
+   close(mazeFile);
+   close(distanceFile);
+   close(edgeFile);
+}
+
+int TiledFlood::getRows() {
+   return rows;
+}
+
+int TiledFlood::getCols() {
+   return cols;
+}
+
+TiledStats TiledFlood::getStats() {
+   return stats;
+}
+
+void TiledFlood::readAt(int file, void* data, long bytes, long offset) {
+   char* into = (char*) data;
+   while(bytes > 0) {
+      ssize_t done = pread(file, into, bytes, offset);
+      if(done <= 0) {
+         throw std::runtime_error("Could not read a maze or scratch file");
+      }
+      into += done;
+      bytes -= done;
+      offset += done;
+      stats.bytesRead += done;
+   }
+}
+
+void TiledFlood::writeAt(int file, void* data, long bytes, long offset) {
+   char* from = (char*) data;
+   while(bytes > 0) {
+      ssize_t done = pwrite(file, from, bytes, offset);
+      if(done <= 0) {
+         throw std::runtime_error("Could not write a scratch file");
+      }
+      from += done;
+      bytes -= done;
+      offset += done;
+      stats.bytesWritten += done;
+   }
+}
+
+void TiledFlood::updatePeak() {
+   long cells = (long) tileSize * tileSize;
+   long bytes = (long) resident.size() * cells * (sizeof(char) + sizeof(int))
+                + (long) seeds.capacity() * sizeof(Seed)
+                + (long) queue.capacity() * sizeof(int)
+                + (long) (oldEdges.capacity() + edges.capacity()) * sizeof(int);
+   stats.peakResidentBytes = std::max(stats.peakResidentBytes, bytes);
+}
+
+void TiledFlood::writeTile(Tile& tile) {
+   long cells = (long) tileSize * tileSize;
+   if(tile.dirty) {
+      writeAt(distanceFile, tile.distances, cells * sizeof(int), tile.id * cells * sizeof(int));
+      tile.dirty = false;
+   }
+}
+
+TiledFlood::Tile& TiledFlood::loadTile(int id) {
+   useCounter++;
+
+   for(Tile& tile : resident) {
+      if(tile.id == id) {
+         tile.lastUse = useCounter;
+         return tile;
+      }
+   }
+
+   // Take the least recently used tile's place if there is no room, otherwise make a new one
+   long cells = (long) tileSize * tileSize;
+   Tile* tile = NULL;
+   if((int) resident.size() == maxResidentTiles) {
+      tile = &resident[0];
+      for(Tile& other : resident) {
+         if(other.lastUse < tile->lastUse) {
+            tile = &other;
+         }
+      }
+      writeTile(*tile);
+      stats.tileEvictions++;
+   } else {
+      Tile fresh;
+      fresh.cells = new char[cells];
+      fresh.distances = new int[cells];
+      resident.push_back(fresh);
+      tile = &resident.back();
+      updatePeak();
+   }
+   tile->id = id;
+   tile->dirty = false;
+   tile->lastUse = useCounter;
+   stats.tileLoads++;
+
+   // Read the part of every row that is in the tile, anything past the maze is '\0'
+   int tileX = id % tilesX * tileSize;
+   int tileY = id / tilesX * tileSize;
+   for(int row = 0; row < tileSize; ++row) {
+      char* cellRow = tile->cells + (long) row * tileSize;
+      int count = 0;
+      if(tileY + row < rows) {
+         count = std::min(tileSize, cols - tileX);
+         readAt(mazeFile, cellRow, count, (tileY + row) * stride + tileX);
+      }
+      std::fill(cellRow + count, cellRow + tileSize, '\0');
+   }
+
+   if(flooded[id]) {
+      readAt(distanceFile, tile->distances, cells * sizeof(int), id * cells * sizeof(int));
+   } else {
+      std::fill(tile->distances, tile->distances + cells, NOT_REACHED);
+   }
+
+   return *tile;
+}
+
+int TiledFlood::edgeCell(int side, int i) {
+   int cell = 0;
+   if(side == 0) {
+      cell = i;
+   } else if(side == 1) {
+      cell = (tileSize - 1) * tileSize + i;
+   } else if(side == 2) {
+      cell = i * tileSize;
+   } else {
+      cell = i * tileSize + tileSize - 1;
+   }
+   return cell;
+}
+
+void TiledFlood::addEdgeSeeds(Tile& tile, int side) {
+   int tileX = tile.id % tilesX;
+   int tileY = tile.id / tilesX;
+
+   // The neighbour on that side, and its edge that touches this tile
+   int neighbour = -1;
+   int neighbourSide = 0;
+   if(side == 0 && tileY > 0) {
+      neighbour = tile.id - tilesX;
+      neighbourSide = 1;
+   } else if(side == 1 && tileY < tilesY - 1) {
+      neighbour = tile.id + tilesX;
+      neighbourSide = 0;
+   } else if(side == 2 && tileX > 0) {
+      neighbour = tile.id - 1;
+      neighbourSide = 3;
+   } else if(side == 3 && tileX < tilesX - 1) {
+      neighbour = tile.id + 1;
+      neighbourSide = 2;
+   }
+
+   // edges is not used until the tile's own edges are saved, so the neighbour's edge is read into it
+   if(neighbour >= 0 && flooded[neighbour]) {
+      int* edge = edges.data();
+      readAt(edgeFile, edge, (long) tileSize * sizeof(int),
+             ((long) neighbour * TILE_SIDES + neighbourSide) * tileSize * sizeof(int));
+
+      for(int i = 0; i < tileSize; ++i) {
+         int cell = edgeCell(side, i);
+         int distance = tile.distances[cell];
+         if(edge[i] != NOT_REACHED && tile.cells[cell] == '.' &&
+            (distance == NOT_REACHED || edge[i] + 1 < distance)) {
+            seeds.push_back({edge[i] + 1, cell});
+         }
+      }
+   }
+}
+
+void TiledFlood::floodTile(int id) {
+   Tile& tile = loadTile(id);
+   int* distances = tile.distances;
+
+   // Everything coming in that is shorter than what the tile has now
+   seeds.clear();
+   if(id == startTile && distances[startCell] != 0) {
+      seeds.push_back({0, startCell});
+   }
+   for(int side = 0; side < TILE_SIDES; ++side) {
+      addEdgeSeeds(tile, side);
+   }
+   if(seeds.empty()) {
+      return;
+   }
+   stats.tilePasses++;
+   flooded[id] = 1;
+   tile.dirty = true;
+
+   // Keep the old edges, to find out which neighbours have to be told
+   for(int side = 0; side < TILE_SIDES; ++side) {
+      for(int i = 0; i < tileSize; ++i) {
+         oldEdges[side * tileSize + i] = distances[edgeCell(side, i)];
+      }
+   }
+
+   std::sort(seeds.begin(), seeds.end(), [](const Seed& a, const Seed& b) {
+      return a.distance < b.distance;
+   });
+   for(Seed& seed : seeds) {
+      if(distances[seed.cell] == NOT_REACHED || seed.distance < distances[seed.cell]) {
+         distances[seed.cell] = seed.distance;
+      }
+   }
+
+   // Breadth-first from the seeds in order of distance: a seed joins the flood when the
+   // queue gets to its distance, so every cell is still reached first by its shortest way in
+   queue.clear();
+   unsigned int head = 0;
+   unsigned int nextSeed = 0;
+   while(head < queue.size() || nextSeed < seeds.size()) {
+      int cell = 0;
+      if(head < queue.size() &&
+         (nextSeed == seeds.size() || distances[queue[head]] <= seeds[nextSeed].distance)) {
+         cell = queue[head];
+         head++;
+      } else {
+         Seed& seed = seeds[nextSeed];
+         nextSeed++;
+         if(distances[seed.cell] != seed.distance) {
+            continue;
+         }
+         cell = seed.cell;
+      }
+
+      int x = cell % tileSize;
+      int y = cell / tileSize;
+      int next[TILE_SIDES] = {
+         y > 0 ? cell - tileSize : -1,
+         y < tileSize - 1 ? cell + tileSize : -1,
+         x > 0 ? cell - 1 : -1,
+         x < tileSize - 1 ? cell + 1 : -1
+      };
+      for(int i = 0; i < TILE_SIDES; ++i) {
+         int n = next[i];
+         if(n >= 0 && tile.cells[n] == '.' &&
+            (distances[n] == NOT_REACHED || distances[cell] + 1 < distances[n])) {
+            distances[n] = distances[cell] + 1;
+            queue.push_back(n);
+         }
+      }
+   }
+   updatePeak();
+
+   // Save the new edges, and tell every neighbour whose edge got shorter
+   int tileX = id % tilesX;
+   int tileY = id / tilesX;
+   int neighbours[TILE_SIDES] = {
+      tileY > 0 ? id - tilesX : -1,
+      tileY < tilesY - 1 ? id + tilesX : -1,
+      tileX > 0 ? id - 1 : -1,
+      tileX < tilesX - 1 ? id + 1 : -1
+   };
+   for(int side = 0; side < TILE_SIDES; ++side) {
+      int shortest = INT_MAX;
+      for(int i = 0; i < tileSize; ++i) {
+         int distance = distances[edgeCell(side, i)];
+         edges[side * tileSize + i] = distance;
+         if(distance != oldEdges[side * tileSize + i]) {
+            shortest = std::min(shortest, distance);
+         }
+      }
+
+      if(neighbours[side] >= 0 && shortest != INT_MAX && shortest + 1 < pending[neighbours[side]]) {
+         pending[neighbours[side]] = shortest + 1;
+         active.push_back({shortest + 1, neighbours[side]});
+         std::push_heap(active.begin(), active.end(), std::greater<std::pair<int, int>>());
+      }
+   }
+   writeAt(edgeFile, edges.data(), (long) TILE_SIDES * tileSize * sizeof(int),
+           (long) id * TILE_SIDES * tileSize * sizeof(int));
+}
+
+void TiledFlood::flood(int fromX, int fromY) {
+
+   // Forget the last flood, the tiles in memory are dropped without writing them
+   std::fill(flooded.begin(), flooded.end(), 0);
+   std::fill(pending.begin(), pending.end(), INT_MAX);
+   for(Tile& tile : resident) {
+      delete[] tile.cells;
+      delete[] tile.distances;
+   }
+   resident.clear();
+   active.clear();
+   startTile = -1;
+
+   if(fromX < 0 || fromX >= cols || fromY < 0 || fromY >= rows) {
+      return;
+   }
+   startTile = fromY / tileSize * tilesX + fromX / tileSize;
+   startCell = fromY % tileSize * tileSize + fromX % tileSize;
+
+   // Flood the tile with the shortest way in next, until no edge gets any shorter
+   pending[startTile] = 0;
+   active.push_back({0, startTile});
+   while(!active.empty()) {
+      std::pop_heap(active.begin(), active.end(), std::greater<std::pair<int, int>>());
+      std::pair<int, int> next = active.back();
+      active.pop_back();
+
+      if(pending[next.second] == next.first) {
+         pending[next.second] = INT_MAX;
+         floodTile(next.second);
+      }
+   }
+}
+
+int TiledFlood::getDistance(int x, int y) {
+   int distance = NOT_REACHED;
+
+   if(x >= 0 && x < cols && y >= 0 && y < rows) {
+      int id = y / tileSize * tilesX + x / tileSize;
+      if(flooded[id]) {
+         distance = loadTile(id).distances[y % tileSize * tileSize + x % tileSize];
+      }
+   }
+
+   return distance;
+}
+
+long TiledFlood::writePositions(std::ostream& out) {
+   long written = 0;
+
+   for(int id = 0; id < tilesX * tilesY; ++id) {
+      if(flooded[id]) {
+         Tile& tile = loadTile(id);
+         int tileX = id % tilesX * tileSize;
+         int tileY = id / tilesX * tileSize;
+
+         for(int cell = 0; cell < tileSize * tileSize; ++cell) {
+            if(tile.distances[cell] > 0) {
+               out << "(" << tileX + cell % tileSize << "," << tileY + cell / tileSize
+                   << "," << tile.distances[cell] << ")" << '\n';
+               written++;
+            }
+         }
+      }
+   }
+
+   return written;
+}
@@ -0,0 +1,173 @@
+#ifndef COSC_ASS_ONE_TILED_FLOOD
+#define COSC_ASS_ONE_TILED_FLOOD
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// What a TiledFlood read, wrote and kept in memory
+struct TiledStats {
+   // Bytes read from the maze file and the scratch files
+   long bytesRead;
+
+   // Bytes written to the scratch files
+   long bytesWritten;
+
+   // Number of times a tile was read into memory, and written out to make room
+   long tileLoads;
+   long tileEvictions;
+
+   // Number of times a tile was flooded (a tile is flooded again when a shorter way in is found)
+   long tilePasses;
+
+   // Most bytes of tiles and flood buffers in memory at once
+   long peakResidentBytes;
+
+   // Bytes of bookkeeping kept for every tile (a few bytes per tile, not per cell)
+   long tileInfoBytes;
+};
+
+// Breadth-first flood fill of a maze file that does not have to fit in memory.
+//    The maze is cut into tileSize x tileSize tiles. At most maxResidentTiles
+//    tiles (their cells and distances) are in memory at once, the distances
+//    of the other tiles are kept in a scratch file, and the distances along
+//    the four edges of every tile in a second scratch file.
+//    A tile is flooded on its own, starting from the cells on its edges that
+//    a neighbouring tile reached, and if that gives its own edges a shorter
+//    distance the neighbours on those edges are flooded again. Tiles are
+//    flooded in order of the shortest distance coming into them, so most
+//    tiles are only flooded once, and the distances are the same as a flood
+//    fill of the whole maze.
+//    The maze file is one row per line, every line the same length (see MazeFile.h).
+//    The scratch files are removed as soon as they are made, so they go away when the flood fill does.
+class TiledFlood {
+public:
+
+   // Open the maze file, and make the scratch files in scratchDirectory
+   //    Throws std::runtime_error if a file cannot be opened
+   TiledFlood(std::string mazeFilename, std::string scratchDirectory,
+              int tileSize, int maxResidentTiles);
+
+   // Close the files, which removes the scratch files
+   ~TiledFlood();
+
+   // Flood the maze from (fromX,fromY)
+   void flood(int fromX, int fromY);
+
+   // Distance from the start of (x,y), or -1 if it was not reached
+   //    This may read the tile of (x,y) from the scratch file
+   int getDistance(int x, int y);
+
+   // Write every position reached except the start, one "(x,y,distance)" per line
+   //    (the same format as a .pos file), one tile at a time
+   //    Returns the number of positions written
+   long writePositions(std::ostream& out);
+
+   // Number of rows in the maze
+   int getRows();
+
+   // Number of columns in the maze
+   int getCols();
+
+   // What the flood fill read, wrote and kept in memory so far
+   TiledStats getStats();
+
+   TiledFlood(TiledFlood& other) = delete;
+   TiledFlood& operator=(TiledFlood& other) = delete;
+
+private:
+
+   // A tile in memory
+   struct Tile {
+      // Which tile it is
+      int id;
+
+      // The cells, row by row, cells outside the maze are '\0'
+      char* cells;
+
+      // The distances, row by row, -1 for a cell not reached
+      int* distances;
+
+      // Checks if the distances changed since the tile was read
+      bool dirty;
+
+      // When the tile was last used, for picking the tile to write out
+      long lastUse;
+   };
+
+   // A cell to start a tile's flood from
+   struct Seed {
+      int distance;
+      int cell;
+   };
+
+   // The maze file, and the scratch files for the distances and the tile edges
+   int mazeFile;
+   int distanceFile;
+   int edgeFile;
+
+   // Size of the maze, and length of one line of the maze file
+   int rows;
+   int cols;
+   long stride;
+
+   // Tile size, and number of tiles across and down
+   int tileSize;
+   int tilesX;
+   int tilesY;
+
+   // The tiles in memory
+   std::vector<Tile> resident;
+   int maxResidentTiles;
+   long useCounter;
+
+   // For every tile: checks if it has been flooded, so it has distances and edges
+   // Its distances are in memory if it is resident, and in the scratch file otherwise
+   // (a tile that was never flooded has no distances yet, so it is all -1)
+   std::vector<char> flooded;
+
+   // For every tile: the shortest distance coming into it that it has not been flooded with yet
+   std::vector<int> pending;
+
+   // The tiles waiting to be flooded again, as a heap of (distance coming in, tile)
+   // A tile can be in here more than once, only the entry that matches pending counts
+   std::vector<std::pair<int, int>> active;
+
+   // Tile the flood started in, and the start's cell in that tile
+   int startTile;
+   int startCell;
+
+   // Flood buffers, kept between tiles
+   std::vector<Seed> seeds;
+   std::vector<int> queue;
+   std::vector<int> oldEdges;
+   std::vector<int> edges;
+
+   TiledStats stats;
+
+   // Get a tile into memory, writing out the least recently used one if there is no room
+   Tile& loadTile(int id);
+
+   // Write a tile's distances to the scratch file if they changed
+   void writeTile(Tile& tile);
+
+   // Flood one tile from its start cell and its edges, telling the neighbours if their edges changed
+   void floodTile(int id);
+
+   // Add the seeds coming in over one edge of tile id from its neighbour
+   //    side is 0 top, 1 bottom, 2 left, 3 right
+   void addEdgeSeeds(Tile& tile, int side);
+
+   // The cell of a tile on the given side, at position i along that side
+   int edgeCell(int side, int i);
+
+   // Read or write bytes at an offset of a file, throwing std::runtime_error on failure
+   void readAt(int file, void* data, long bytes, long offset);
+   void writeAt(int file, void* data, long bytes, long offset);
+
+   // Remember how many bytes are in memory now, if it is the most so far
+   void updatePeak();
+};
+
+#endif // COSC_ASS_ONE_TILED_FLOOD
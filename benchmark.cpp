@@ -0,0 +1,618 @@
+#include "MazeGenerator.h"
+#include "PathPlanning.h"
+#include "Types.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/*
+ * Compares the search engines of PathPlanning on generated mazes.
+ *
+ * Full command
+ *    ./benchmark [queries] [seed]
+ *    ./benchmark scaling [side] [threads] [queries]
+ *    ./benchmark hierarchical [side] [threads] [queries]
+ *    ./benchmark suite [max cells] [queries] [seed]
+ *
+ * For every maze, the same random (start, goal) pairs are answered by every
+ * engine (alt is astar with LANDMARK_COUNT landmarks). The table shows the average number of cells expanded per query,
+ * the average time per query, and how many times fewer cells were expanded
+ * than the full flood fill.
+ *
+ * The scaling mode floods one side x side open room (5% blocked) with
+ * ENGINE_PARALLEL using 1, 2, 4, ... up to the given number of threads
+ * (the number of cores by default), and shows the speed-up over one thread.
+ *
+ * The hierarchical mode builds the cluster graph of ENGINE_HIERARCHICAL for
+ * side x side mazes (1024 by default) with 1, 2, 4, ... threads, then answers
+ * the same queries with ENGINE_FLOOD and ENGINE_HIERARCHICAL, and shows the
+ * time per query and how much longer the hierarchical paths are.
+ *
+ * The suite mode generates open rooms, perfect mazes, spirals and noise maps
+ * of 10^2, 10^4, ... cells, up to the given number of cells (10^6 by default,
+ * 10^8 is the largest that is sensible). For each one it times the
+ * PathPlanning constructor, getReachablePositions and getPath, and prints
+ * everything as one JSON object: the reachable cells flooded per second,
+ * the mean, 50th, 90th and 99th percentile and slowest getPath times, and
+ * the peak resident memory. Every maze is run in a process of its own, so
+ * the peak memory is only that maze's, and a maze too big for the machine
+ * only loses its own result. Compiled with -DPATH_PLANNING_STATS, each
+ * maze also has the PlannerStats of its planner.
+ */
+
+#define ARGV_QUERIES      1
+#define ARGV_SEED         2
+#define DEFAULT_QUERIES   20
+#define DEFAULT_SEED      1
+
+#define ARGV_SCALING_SIDE     2
+#define ARGV_SCALING_THREADS  3
+#define ARGV_SCALING_QUERIES  4
+#define DEFAULT_SCALING_SIDE  3200
+#define DEFAULT_SCALING_QUERIES 5
+
+#define DEFAULT_HIERARCHICAL_SIDE    1024
+#define DEFAULT_HIERARCHICAL_QUERIES 100
+
+#define ARGV_SUITE_CELLS       2
+#define ARGV_SUITE_QUERIES     3
+#define ARGV_SUITE_SEED        4
+#define DEFAULT_SUITE_CELLS    1000000
+#define DEFAULT_SUITE_QUERIES  20
+#define SUITE_OPEN_PERCENT     20
+#define SUITE_NOISE_PERCENT    40
+
+// A maze layout to benchmark
+//    "open" is a room with obstaclePercent percent of the cells blocked,
+//    "perfect" is a maze of one cell wide corridors,
+//    "spiral" is one corridor spiralling into the middle,
+//    "noise" is a map of blocked patches covering about obstaclePercent percent of the cells
+struct Layout {
+   std::string name;
+   int rows;
+   int cols;
+   int obstaclePercent;
+};
+
+// A search engine to benchmark
+//    With landmarks, the engine is given a LandmarkIndex of the maze, built before the queries
+struct Engine {
+   std::string name;
+   SearchEngine engine;
+   bool landmarks;
+};
+
+// A query, from (startX,startY) to (goalX,goalY)
+struct Query {
+   int startX;
+   int startY;
+   int goalX;
+   int goalY;
+};
+
+Grid make_layout(MazeGenerator& generator, Layout& layout);
+void run_layout(MazeGenerator& generator, Layout& layout,
+                std::vector<Engine>& engines, int numQueries);
+void run_scaling(int side, int maxThreads, int numQueries);
+void run_hierarchical(int side, int maxThreads, int numQueries);
+int next_thread_count(int threads, int maxThreads);
+void run_suite(long maxCells, int numQueries, unsigned int seed);
+std::string run_suite_layout(Layout& layout, int numQueries, unsigned int seed);
+double percentile(std::vector<double>& sorted, double percent);
+
+int main(int argc, char** argv) {
+   if(argc > 1 && std::string(argv[1]) == "scaling") {
+      int side = argc > ARGV_SCALING_SIDE ? std::atoi(argv[ARGV_SCALING_SIDE]) : DEFAULT_SCALING_SIDE;
+      int maxThreads = argc > ARGV_SCALING_THREADS ? std::atoi(argv[ARGV_SCALING_THREADS])
+                                                   : (int) std::thread::hardware_concurrency();
+      int numQueries = argc > ARGV_SCALING_QUERIES ? std::atoi(argv[ARGV_SCALING_QUERIES])
+                                                   : DEFAULT_SCALING_QUERIES;
+      run_scaling(side, maxThreads < 1 ? 1 : maxThreads, numQueries);
+      return 0;
+   }
+
+   // The hierarchical mode takes the same arguments as the scaling mode
+   if(argc > 1 && std::string(argv[1]) == "hierarchical") {
+      int side = argc > ARGV_SCALING_SIDE ? std::atoi(argv[ARGV_SCALING_SIDE])
+                                          : DEFAULT_HIERARCHICAL_SIDE;
+      int maxThreads = argc > ARGV_SCALING_THREADS ? std::atoi(argv[ARGV_SCALING_THREADS])
+                                                   : (int) std::thread::hardware_concurrency();
+      int numQueries = argc > ARGV_SCALING_QUERIES ? std::atoi(argv[ARGV_SCALING_QUERIES])
+                                                   : DEFAULT_HIERARCHICAL_QUERIES;
+      run_hierarchical(side, maxThreads < 1 ? 1 : maxThreads, numQueries);
+      return 0;
+   }
+
+   if(argc > 1 && std::string(argv[1]) == "suite") {
+      long maxCells = argc > ARGV_SUITE_CELLS ? std::atol(argv[ARGV_SUITE_CELLS]) : DEFAULT_SUITE_CELLS;
+      int numQueries = argc > ARGV_SUITE_QUERIES ? std::atoi(argv[ARGV_SUITE_QUERIES])
+                                                 : DEFAULT_SUITE_QUERIES;
+      unsigned int seed = argc > ARGV_SUITE_SEED ? std::atoi(argv[ARGV_SUITE_SEED]) : DEFAULT_SEED;
+      run_suite(maxCells, numQueries, seed);
+      return 0;
+   }
+
+   int numQueries = argc > ARGV_QUERIES ? std::atoi(argv[ARGV_QUERIES]) : DEFAULT_QUERIES;
+   unsigned int seed = argc > ARGV_SEED ? std::atoi(argv[ARGV_SEED]) : DEFAULT_SEED;
+
+   MazeGenerator generator(seed);
+
+   std::vector<Layout> layouts = {
+      {"open", 64, 64, 5},
+      {"open", 256, 256, 5},
+      {"open", 1024, 1024, 5},
+      {"open", 64, 64, 20},
+      {"open", 256, 256, 20},
+      {"open", 1024, 1024, 20},
+      {"perfect", 63, 63, 0},
+      {"perfect", 255, 255, 0},
+      {"perfect", 1023, 1023, 0},
+   };
+
+   // The flood fill comes first, the other engines are compared to it
+   std::vector<Engine> engines = {
+      {"flood", ENGINE_FLOOD, false},
+      {"astar", ENGINE_ASTAR, false},
+      {"alt", ENGINE_ASTAR, true},
+      {"bidir", ENGINE_BIDIRECTIONAL, false},
+      {"jps", ENGINE_JPS, false},
+      {"bitboard", ENGINE_BITBOARD, false},
+      {"parallel", ENGINE_PARALLEL, false},
+   };
+
+   std::cout << std::left
+             << std::setw(10) << "layout"
+             << std::setw(10) << "blocked%"
+             << std::setw(12) << "cells"
+             << std::setw(10) << "engine"
+             << std::setw(14) << "expanded"
+             << std::setw(12) << "ms/query"
+             << "fewer than flood"
+             << std::endl;
+
+   for(Layout& layout : layouts) {
+      run_layout(generator, layout, engines, numQueries);
+   }
+
+   return 0;
+}
+
+Grid make_layout(MazeGenerator& generator, Layout& layout) {
+   Grid grid = NULL;
+
+   if(layout.name == "open") {
+      grid = generator.openRoom(layout.rows, layout.cols, layout.obstaclePercent);
+   } else if(layout.name == "spiral") {
+      grid = generator.spiral(layout.rows, layout.cols);
+   } else if(layout.name == "noise") {
+      grid = generator.noiseMap(layout.rows, layout.cols, layout.obstaclePercent);
+   } else {
+      grid = generator.perfectMaze(layout.rows, layout.cols);
+   }
+
+   return grid;
+}
+
+void run_layout(MazeGenerator& generator, Layout& layout,
+                std::vector<Engine>& engines, int numQueries) {
+
+   Grid grid = make_layout(generator, layout);
+
+   // Pick the queries before the planner takes the grid
+   std::vector<Query> queries;
+   for(int i = 0; i < numQueries; ++i) {
+      Query query;
+      generator.randomOpenCell(grid, layout.rows, layout.cols, query.startX, query.startY);
+      generator.randomOpenCell(grid, layout.rows, layout.cols, query.goalX, query.goalY);
+      queries.push_back(query);
+   }
+
+   // The planner and the landmarks share one maze
+   Maze* maze = new Maze(grid, layout.rows, layout.cols);
+   for(int y = 0; y < layout.rows; ++y) {
+      delete[] grid[y];
+   }
+   delete[] grid;
+   PathPlanning* planner = new PathPlanning(maze);
+   LandmarkIndex* landmarks = new LandmarkIndex(maze, LANDMARK_COUNT);
+
+   // Path lengths of the first engine, every other engine must match them
+   std::vector<int> lengths;
+   double floodExpanded = 0;
+
+   for(Engine& engine : engines) {
+      double expanded = 0;
+      double seconds = 0;
+      bool lengthsMatch = true;
+      planner->setLandmarks(engine.landmarks ? landmarks : NULL);
+
+      for(int i = 0; i < numQueries; ++i) {
+         Query& query = queries[i];
+         planner->initialPosition(query.startX, query.startY);
+
+         auto start = std::chrono::steady_clock::now();
+         PDList* path = planner->getPath(query.goalX, query.goalY, engine.engine);
+         auto end = std::chrono::steady_clock::now();
+
+         seconds += std::chrono::duration<double>(end - start).count();
+         expanded += planner->getNodesExpanded();
+
+         if(lengths.size() < queries.size()) {
+            lengths.push_back(path->size());
+         } else if(lengths[i] != path->size()) {
+            lengthsMatch = false;
+         }
+         delete path;
+      }
+
+      expanded /= numQueries;
+      if(floodExpanded == 0) {
+         floodExpanded = expanded;
+      }
+
+      std::cout << std::left
+                << std::setw(10) << layout.name
+                << std::setw(10) << layout.obstaclePercent
+                << std::setw(12) << (long) layout.rows * layout.cols
+                << std::setw(10) << engine.name
+                << std::setw(14) << std::fixed << std::setprecision(0) << expanded
+                << std::setw(12) << std::setprecision(3) << seconds * 1000 / numQueries
+                << std::setprecision(1) << floodExpanded / expanded << "x"
+                << (lengthsMatch ? "" : "  PATH LENGTH MISMATCH")
+                << std::endl;
+   }
+
+   delete planner;
+   delete landmarks;
+   delete maze;
+}
+
+void run_scaling(int side, int maxThreads, int numQueries) {
+   MazeGenerator generator(DEFAULT_SEED);
+   Grid grid = generator.openRoom(side, side, 5);
+
+   // Every thread count floods from the same starts
+   std::vector<Query> queries;
+   for(int i = 0; i < numQueries; ++i) {
+      Query query;
+      generator.randomOpenCell(grid, side, side, query.startX, query.startY);
+      generator.randomOpenCell(grid, side, side, query.goalX, query.goalY);
+      queries.push_back(query);
+   }
+
+   PathPlanning* planner = new PathPlanning(grid, side, side);
+
+   std::cout << std::left
+             << std::setw(12) << "cells"
+             << std::setw(10) << "threads"
+             << std::setw(14) << "reached"
+             << std::setw(12) << "ms/flood"
+             << "speed-up"
+             << std::endl;
+
+   double oneThread = 0;
+   int threads = 1;
+   while(threads <= maxThreads) {
+      planner->setFloodThreads(threads);
+
+      // The first flood starts the threads, so it is not timed
+      planner->initialPosition(queries[0].goalX, queries[0].goalY);
+      delete planner->getPath(queries[0].startX, queries[0].startY, ENGINE_PARALLEL);
+
+      double seconds = 0;
+      double reached = 0;
+      for(Query& query : queries) {
+         planner->initialPosition(query.startX, query.startY);
+
+         auto start = std::chrono::steady_clock::now();
+         PDList* path = planner->getPath(query.goalX, query.goalY, ENGINE_PARALLEL);
+         auto end = std::chrono::steady_clock::now();
+
+         seconds += std::chrono::duration<double>(end - start).count();
+         reached += planner->getNodesExpanded();
+         delete path;
+      }
+
+      double ms = seconds * 1000 / numQueries;
+      if(oneThread == 0) {
+         oneThread = ms;
+      }
+
+      std::cout << std::left
+                << std::setw(12) << (long) side * side
+                << std::setw(10) << threads
+                << std::setw(14) << std::fixed << std::setprecision(0) << reached / numQueries
+                << std::setw(12) << std::setprecision(3) << ms
+                << std::setprecision(2) << oneThread / ms << "x"
+                << std::endl;
+
+      threads = next_thread_count(threads, maxThreads);
+   }
+
+   delete planner;
+}
+
+int next_thread_count(int threads, int maxThreads) {
+
+   // Double the threads, but always finish with maxThreads
+   if(threads < maxThreads && threads * 2 > maxThreads) {
+      threads = maxThreads;
+   } else {
+      threads *= 2;
+   }
+
+   return threads;
+}
+
+void run_hierarchical(int side, int maxThreads, int numQueries) {
+   MazeGenerator generator(DEFAULT_SEED);
+
+   // A perfect maze needs an odd size
+   std::vector<Layout> layouts = {
+      {"open", side, side, 5},
+      {"open", side, side, 20},
+      {"perfect", side | 1, side | 1, 0},
+   };
+
+   for(Layout& layout : layouts) {
+      Grid grid = make_layout(generator, layout);
+
+      std::vector<Query> queries;
+      for(int i = 0; i < numQueries; ++i) {
+         Query query;
+         generator.randomOpenCell(grid, layout.rows, layout.cols, query.startX, query.startY);
+         generator.randomOpenCell(grid, layout.rows, layout.cols, query.goalX, query.goalY);
+         queries.push_back(query);
+      }
+
+      // The planner and the graphs built here share one maze
+      Maze* maze = new Maze(grid, layout.rows, layout.cols);
+      for(int y = 0; y < layout.rows; ++y) {
+         delete[] grid[y];
+      }
+      delete[] grid;
+
+      std::cout << layout.name << " " << layout.rows << "x" << layout.cols
+                << ", " << layout.obstaclePercent << "% blocked, clusters of "
+                << HPA_CLUSTER_SIZE << std::endl;
+      std::cout << std::left
+                << std::setw(10) << "threads"
+                << std::setw(12) << "nodes"
+                << std::setw(12) << "edges"
+                << "build ms"
+                << std::endl;
+
+      int threads = 1;
+      while(threads <= maxThreads) {
+         auto start = std::chrono::steady_clock::now();
+         HierarchicalSearch* graph = new HierarchicalSearch(maze, HPA_CLUSTER_SIZE, threads);
+         auto end = std::chrono::steady_clock::now();
+
+         std::cout << std::left
+                   << std::setw(10) << threads
+                   << std::setw(12) << graph->getNumNodes()
+                   << std::setw(12) << graph->getNumEdges()
+                   << std::fixed << std::setprecision(3)
+                   << std::chrono::duration<double>(end - start).count() * 1000
+                   << std::endl;
+         delete graph;
+
+         threads = next_thread_count(threads, maxThreads);
+      }
+
+      // Build the graph before timing the queries
+      PathPlanning* planner = new PathPlanning(maze);
+      planner->setFloodThreads(maxThreads);
+      planner->initialPosition(queries[0].startX, queries[0].startY);
+      delete planner->getPath(queries[0].goalX, queries[0].goalY, ENGINE_HIERARCHICAL);
+
+      std::cout << std::left
+                << std::setw(14) << "engine"
+                << std::setw(14) << "expanded"
+                << std::setw(12) << "ms/query"
+                << "longer than shortest"
+                << std::endl;
+
+      std::vector<int> lengths;
+      Engine engines[] = {{"flood", ENGINE_FLOOD, false}, {"hierarchical", ENGINE_HIERARCHICAL, false}};
+      for(Engine& engine : engines) {
+         double expanded = 0;
+         double seconds = 0;
+         long extraSteps = 0;
+         long shortestSteps = 0;
+
+         for(int i = 0; i < numQueries; ++i) {
+            Query& query = queries[i];
+            planner->initialPosition(query.startX, query.startY);
+
+            auto start = std::chrono::steady_clock::now();
+            PDList* path = planner->getPath(query.goalX, query.goalY, engine.engine);
+            auto end = std::chrono::steady_clock::now();
+
+            seconds += std::chrono::duration<double>(end - start).count();
+            expanded += planner->getNodesExpanded();
+
+            if(lengths.size() < queries.size()) {
+               lengths.push_back(path->size());
+            } else {
+               extraSteps += path->size() - lengths[i];
+               shortestSteps += lengths[i];
+            }
+            delete path;
+         }
+
+         std::cout << std::left
+                   << std::setw(14) << engine.name
+                   << std::setw(14) << std::fixed << std::setprecision(0) << expanded / numQueries
+                   << std::setw(12) << std::setprecision(3) << seconds * 1000 / numQueries
+                   << std::setprecision(2)
+                   << (shortestSteps == 0 ? 0.0 : 100.0 * extraSteps / shortestSteps) << "%"
+                   << std::endl;
+      }
+      std::cout << std::endl;
+
+      delete planner;
+      delete maze;
+   }
+}
+
+void run_suite(long maxCells, int numQueries, unsigned int seed) {
+
+   // A perfect maze needs an odd size
+   std::vector<Layout> layouts;
+   for(int side = 10; (long) side * side <= maxCells; side *= 10) {
+      layouts.push_back({"open", side, side, SUITE_OPEN_PERCENT});
+      layouts.push_back({"perfect", side | 1, side | 1, 0});
+      layouts.push_back({"spiral", side, side, 0});
+      layouts.push_back({"noise", side, side, SUITE_NOISE_PERCENT});
+   }
+
+   std::cout << "{\"benchmark\": \"suite\", \"seed\": " << seed
+             << ", \"queries\": " << numQueries << ", \"results\": [" << std::endl;
+
+   for(unsigned int i = 0; i < layouts.size(); ++i) {
+      Layout& layout = layouts[i];
+      if(i > 0) {
+         std::cout << "," << std::endl;
+      }
+
+      // Nothing may be left in the buffer, or the child would print it again
+      std::cout.flush();
+      pid_t child = fork();
+      if(child == 0) {
+         std::cout << run_suite_layout(layout, numQueries, seed);
+         std::cout.flush();
+         _exit(0);
+      }
+
+      int status = 0;
+      waitpid(child, &status, 0);
+      if(child < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+         std::cout << "  {\"layout\": \"" << layout.name << "\", \"rows\": " << layout.rows
+                   << ", \"cols\": " << layout.cols << ", \"error\": \"the benchmark process "
+                   << (child < 0 ? "could not be started" : "failed, it may have run out of memory")
+                   << "\"}";
+      }
+   }
+
+   std::cout << std::endl << "]}" << std::endl;
+}
+
+std::string run_suite_layout(Layout& layout, int numQueries, unsigned int seed) {
+   MazeGenerator generator(seed);
+
+   auto generateStart = std::chrono::steady_clock::now();
+   Grid grid = make_layout(generator, layout);
+   auto generateEnd = std::chrono::steady_clock::now();
+
+   long openCells = 0;
+   for(int y = 0; y < layout.rows; ++y) {
+      openCells += std::count(grid[y], grid[y] + layout.cols, '.');
+   }
+
+   // Pick the flood's start and the queries before the planner takes the grid
+   int floodX = 0;
+   int floodY = 0;
+   bool anyOpen = generator.randomOpenCell(grid, layout.rows, layout.cols, floodX, floodY);
+   std::vector<Query> queries;
+   for(int i = 0; i < numQueries && anyOpen; ++i) {
+      Query query;
+      generator.randomOpenCell(grid, layout.rows, layout.cols, query.startX, query.startY);
+      generator.randomOpenCell(grid, layout.rows, layout.cols, query.goalX, query.goalY);
+      queries.push_back(query);
+   }
+
+   auto constructStart = std::chrono::steady_clock::now();
+   PathPlanning* planner = new PathPlanning(grid, layout.rows, layout.cols);
+   auto constructEnd = std::chrono::steady_clock::now();
+
+   planner->initialPosition(floodX, floodY);
+   auto reachableStart = std::chrono::steady_clock::now();
+   PDList* reachable = planner->getReachablePositions();
+   auto reachableEnd = std::chrono::steady_clock::now();
+   long reached = reachable->size();
+   delete reachable;
+
+   // Every query has a new start, so every getPath floods the maze again
+   std::vector<double> pathMs;
+   double totalMs = 0;
+   long totalSteps = 0;
+   for(Query& query : queries) {
+      planner->initialPosition(query.startX, query.startY);
+
+      auto start = std::chrono::steady_clock::now();
+      PDList* path = planner->getPath(query.goalX, query.goalY);
+      auto end = std::chrono::steady_clock::now();
+
+      double ms = std::chrono::duration<double>(end - start).count() * 1000;
+      pathMs.push_back(ms);
+      totalMs += ms;
+      totalSteps += path->size();
+      delete path;
+   }
+   std::sort(pathMs.begin(), pathMs.end());
+
+   // Only kept when the benchmark is compiled with -DPATH_PLANNING_STATS, see PlannerStats.h
+   std::ostringstream stats;
+   if(PlannerStats::enabled()) {
+      stats << ", \"stats\": ";
+      planner->getStats().writeJson(stats);
+   }
+
+   delete planner;
+
+   // ru_maxrss is in kilobytes on Linux
+   struct rusage usage;
+   getrusage(RUSAGE_SELF, &usage);
+
+   double reachableSeconds = std::chrono::duration<double>(reachableEnd - reachableStart).count();
+   std::ostringstream json;
+   json << std::fixed << std::setprecision(3)
+        << "  {\"layout\": \"" << layout.name << "\""
+        << ", \"blocked_percent\": " << layout.obstaclePercent
+        << ", \"rows\": " << layout.rows
+        << ", \"cols\": " << layout.cols
+        << ", \"cells\": " << (long) layout.rows * layout.cols
+        << ", \"open_cells\": " << openCells
+        << ", \"generate_ms\": " << std::chrono::duration<double>(generateEnd - generateStart).count() * 1000
+        << ", \"construct_ms\": " << std::chrono::duration<double>(constructEnd - constructStart).count() * 1000
+        << ", \"reachable_ms\": " << reachableSeconds * 1000
+        << ", \"reached\": " << reached
+        << ", \"cells_per_sec\": " << std::setprecision(0)
+        << (reachableSeconds > 0 ? reached / reachableSeconds : 0.0) << std::setprecision(3)
+        << ", \"path_queries\": " << queries.size()
+        << ", \"mean_path_steps\": " << (queries.empty() ? 0.0 : (double) totalSteps / queries.size())
+        << ", \"path_ms\": {\"mean\": " << (queries.empty() ? 0.0 : totalMs / queries.size())
+        << ", \"p50\": " << percentile(pathMs, 50)
+        << ", \"p90\": " << percentile(pathMs, 90)
+        << ", \"p99\": " << percentile(pathMs, 99)
+        << ", \"max\": " << percentile(pathMs, 100) << "}"
+        << ", \"peak_rss_kib\": " << usage.ru_maxrss
+        << stats.str()
+        << "}";
+
+   return json.str();
+}
+
+double percentile(std::vector<double>& sorted, double percent) {
+   double value = 0;
+
+   // The nearest rank: the smallest value that at least percent percent of the values are not above
+   if(!sorted.empty()) {
+      long rank = (long) std::ceil(percent / 100 * sorted.size());
+      value = sorted[std::max(rank, 1L) - 1];
+   }
+
+   return value;
+}
@@ -0,0 +1,57 @@
+#include "LandmarkIndex.h"
+#include "MazeFile.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+/*
+ * Builds the LandmarkIndex of a maze file and saves it, so a program that
+ * plans on the maze can map it in with LandmarkIndex(filename) instead of
+ * building it again.
+ *
+ * Full command
+ *    ./landmarks <maze file> <index file> [landmarks]
+ *
+ * For example:
+ *   ./landmarks sampleTest/test5/test5.maze test5.landmarks 8
+ *
+ * The number of landmarks is LANDMARK_COUNT by default.
+ */
+
+#define ARGV_MAZE       1
+#define ARGV_INDEX      2
+#define ARGV_LANDMARKS  3
+#define REQ_ARGS        2
+
+int main(int argc, char** argv) {
+   if(argc <= REQ_ARGS) {
+      std::cout << "Usage: " << argv[0] << " <maze file> <index file> [landmarks]" << std::endl;
+      return EXIT_FAILURE;
+   }
+   int numLandmarks = argc > ARGV_LANDMARKS ? std::atoi(argv[ARGV_LANDMARKS]) : LANDMARK_COUNT;
+
+   try {
+      MazeFile* mazeFile = new MazeFile(argv[ARGV_MAZE]);
+
+      auto start = std::chrono::steady_clock::now();
+      LandmarkIndex* landmarks = new LandmarkIndex(mazeFile->getMaze(), numLandmarks);
+      auto end = std::chrono::steady_clock::now();
+      landmarks->save(argv[ARGV_INDEX]);
+
+      std::cout << landmarks->getNumLandmarks() << " landmarks for a "
+                << mazeFile->getRows() << "x" << mazeFile->getCols() << " maze in "
+                << std::chrono::duration<double>(end - start).count() * 1000 << " ms, "
+                << landmarks->bytes() << " bytes of distances" << std::endl;
+
+      delete landmarks;
+      delete mazeFile;
+   } catch (std::runtime_error& exception) {
+      std::cout << "Error: " << exception.what() << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   return EXIT_SUCCESS;
+}
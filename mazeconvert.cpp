@@ -0,0 +1,96 @@
+#include "BinaryMazeFile.h"
+#include "MazeFile.h"
+#include "PathPlanning.h"
+#include "PositionParser.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+/*
+ * Converts a test in the text format (testname.maze, testname.initial and
+ * optionally testname.goal) into one binary maze file, see BinaryMazeFile.h.
+ *
+ * Full command
+ *    ./mazeconvert <testname> <binary file> [distances]
+ *
+ * For example:
+ *   ./mazeconvert sampleTest/test5/test5 test5.mzb distances
+ *
+ * Every position of testname.initial is a start, and the position of
+ * testname.goal is a goal. With "distances", the distance field of the first
+ * start is computed with PathPlanning and stored in the file too.
+ */
+
+#define ARGV_TEST       1
+#define ARGV_BINARY     2
+#define ARGV_DISTANCES  3
+#define REQ_ARGS        2
+#define EXT_MAZE        std::string(".maze")
+#define EXT_INT         std::string(".initial")
+#define EXT_GOAL        std::string(".goal")
+
+void load_positions(std::string filename, PDList* positions);
+
+int main(int argc, char** argv) {
+   if(argc <= REQ_ARGS) {
+      std::cout << "Usage: " << argv[0] << " <testname> <binary file> [distances]" << std::endl;
+      return EXIT_FAILURE;
+   }
+   bool withDistances = argc > ARGV_DISTANCES && std::string(argv[ARGV_DISTANCES]) == "distances";
+
+   try {
+      auto start = std::chrono::steady_clock::now();
+      MazeFile* mazeFile = new MazeFile(argv[ARGV_TEST] + EXT_MAZE);
+
+      PDList* starts = new PDList();
+      PDList* goals = new PDList();
+      load_positions(argv[ARGV_TEST] + EXT_INT, starts);
+      if(std::ifstream(argv[ARGV_TEST] + EXT_GOAL).good()) {
+         load_positions(argv[ARGV_TEST] + EXT_GOAL, goals);
+      }
+
+      PathPlanning* planner = NULL;
+      PDList* reachable = NULL;
+      if(withDistances) {
+         if(starts->size() == 0) {
+            throw std::runtime_error("No initial position in file");
+         }
+         planner = new PathPlanning(mazeFile->getMaze());
+         planner->initialPosition(starts->get(0)->getX(), starts->get(0)->getY());
+         reachable = planner->getReachablePositions();
+      }
+
+      BinaryMazeFile::write(argv[ARGV_BINARY], mazeFile->getMaze(), starts, goals, reachable);
+      auto end = std::chrono::steady_clock::now();
+
+      std::cout << "Wrote a " << mazeFile->getRows() << "x" << mazeFile->getCols() << " maze with "
+                << starts->size() << " starts, " << goals->size() << " goals"
+                << (withDistances ? " and distances" : "") << " in "
+                << std::chrono::duration<double>(end - start).count() * 1000 << " ms" << std::endl;
+
+      delete reachable;
+      delete planner;
+      delete goals;
+      delete starts;
+      delete mazeFile;
+   } catch (std::runtime_error& exception) {
+      std::cout << "Error: " << exception.what() << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   return EXIT_SUCCESS;
+}
+
+void load_positions(std::string filename, PDList* positions) {
+   PositionParser parser(filename, POSITION_XY);
+   int x = 0;
+   int y = 0;
+   int distance = 0;
+   while(parser.next(x, y, distance)) {
+      positions->addBack(x, y, 0);
+   }
+}
@@ -0,0 +1,464 @@
+#include "BinaryMazeFile.h"
+#include "MazeFile.h"
+#include "PathPlanning.h"
+#include "PositionParser.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+/*
+ * Answers path queries on mazes that are loaded once, so a query does not
+ * pay for starting a program and reading its maze.
+ *
+ * Full command
+ *    ./mazeserver [--engine <engine>] [--socket <path>] <maze file> [maze file ...]
+ *
+ * For example:
+ *   ./mazeserver sampleTest/test5/test5.maze sampleTest/test6/test6.maze
+ *
+ * A maze file is a text .maze file (MazeFile) or a binary maze file (BinaryMazeFile).
+ * Every maze has one PathPlanning, which is kept for as long as the server runs.
+ * The engine is flood by default, the names are the same as for unit_tests.
+ *
+ * Every line the server reads is a request:
+ *    <maze> (startX,startY) (goalX,goalY)   the path on the maze at that place in the command, from 0
+ *    stats                                  the number of queries answered, the time spent on them
+ *                                           and the queries per second
+ *    quit                                   stop reading
+ * and every request gets one line back, in the same order:
+ *    the path from the start to the goal, as the (x,y,distance) positions of a .path file
+ *    separated by spaces, or an empty line if the goal cannot be reached, or
+ *    error <what was wrong>
+ *
+ * The queries are pipelined: every request that is already waiting (up to SERVER_BATCH_BYTES of them)
+ * is read and answered as one batch, in order of maze and start, so the queries from the same start
+ * share the flood fill PathPlanning keeps for its last start.
+ * The answers of a batch go back in one write.
+ *
+ * Without --socket the requests come from stdin and the answers go to stdout, so a file of
+ * requests can be piped in. With --socket the server listens on a Unix socket at that path
+ * and serves one connection after another until it is stopped, "quit" only ends a connection.
+ * When a connection (or stdin) ends, the number of queries and queries per second go to stderr.
+ */
+
+#define ARGV_FIRST              1
+#define SERVER_READ_BYTES       65536
+#define SERVER_BATCH_BYTES      (1 << 20)
+#define SERVER_BACKLOG          16
+#define SERVER_MAZE_DIGITS      9
+
+// A maze the server plans on
+//    The file it was loaded from owns the maze, only one of mazeFile and binaryFile is set
+struct ServedMaze {
+   MazeFile* mazeFile;
+   BinaryMazeFile* binaryFile;
+   Maze* maze;
+   PathPlanning* planner;
+};
+
+// A path query read from a connection
+//    error is empty unless the request could not be understood
+struct Request {
+   int maze;
+   int startX;
+   int startY;
+   int goalX;
+   int goalY;
+   std::string error;
+};
+
+// Everything the server keeps between connections
+struct Server {
+   std::vector<ServedMaze> mazes;
+   SearchEngine engine;
+
+   // Queries answered and the time spent answering them, since the connection started
+   long queries;
+   double seconds;
+};
+
+SearchEngine engine_from_name(std::string name);
+ServedMaze load_maze(std::string filename);
+void serve(int inFd, int outFd, Server& server);
+bool serve_lines(const char* text, size_t length, long& lineNumber, Server& server, std::string& out);
+void parse_request(const char* text, size_t length, long lineNumber, Server& server, Request& request);
+void answer_batch(std::vector<Request>& batch, Server& server, std::string& out);
+void append_path(PDList* path, std::string& out);
+void append_number(int number, std::string& out);
+bool write_all(int fd, std::string& text);
+void report(Server& server);
+
+int main(int argc, char** argv) {
+   std::string socketPath;
+   std::string engineName = "flood";
+   std::vector<std::string> mazeNames;
+   for(int i = ARGV_FIRST; i < argc; ++i) {
+      std::string arg = argv[i];
+      if(arg == "--socket" && i + 1 < argc) {
+         socketPath = argv[++i];
+      } else if(arg == "--engine" && i + 1 < argc) {
+         engineName = argv[++i];
+      } else {
+         mazeNames.push_back(arg);
+      }
+   }
+   if(mazeNames.empty()) {
+      std::cout << "Usage: " << argv[0]
+                << " [--engine <engine>] [--socket <path>] <maze file> [maze file ...]" << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   // A client that goes away while its answers are written only ends its connection
+   std::signal(SIGPIPE, SIG_IGN);
+
+   Server server;
+   server.queries = 0;
+   server.seconds = 0;
+   int status = EXIT_SUCCESS;
+   try {
+      server.engine = engine_from_name(engineName);
+
+      auto start = std::chrono::steady_clock::now();
+      for(std::string& name : mazeNames) {
+         server.mazes.push_back(load_maze(name));
+      }
+      auto end = std::chrono::steady_clock::now();
+      std::cerr << "Loaded " << server.mazes.size() << " mazes in "
+                << std::chrono::duration<double>(end - start).count() * 1000 << " ms" << std::endl;
+
+      if(socketPath.empty()) {
+         serve(STDIN_FILENO, STDOUT_FILENO, server);
+         report(server);
+      } else {
+         int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+         sockaddr_un address;
+         std::memset(&address, 0, sizeof(address));
+         address.sun_family = AF_UNIX;
+         if(listener < 0 || socketPath.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Could not make socket '" + socketPath + "'");
+         }
+         std::strcpy(address.sun_path, socketPath.c_str());
+
+         // A socket file left by a server that was stopped is replaced
+         unlink(socketPath.c_str());
+         if(bind(listener, (sockaddr*) &address, sizeof(address)) != 0 ||
+            listen(listener, SERVER_BACKLOG) != 0) {
+            close(listener);
+            throw std::runtime_error("Could not listen on socket '" + socketPath + "'");
+         }
+         std::cerr << "Listening on " << socketPath << std::endl;
+
+         while(true) {
+            int connection = accept(listener, NULL, NULL);
+            if(connection >= 0) {
+               server.queries = 0;
+               server.seconds = 0;
+               serve(connection, connection, server);
+               close(connection);
+               report(server);
+            } else if(errno != EINTR) {
+               close(listener);
+               throw std::runtime_error("Could not accept a connection on '" + socketPath + "'");
+            }
+         }
+      }
+   } catch (std::runtime_error& exception) {
+      std::cerr << "Error: " << exception.what() << std::endl;
+      status = EXIT_FAILURE;
+   }
+
+   for(ServedMaze& served : server.mazes) {
+      delete served.planner;
+      delete served.mazeFile;
+      delete served.binaryFile;
+   }
+
+   return status;
+}
+
+SearchEngine engine_from_name(std::string name) {
+   SearchEngine engine = ENGINE_FLOOD;
+
+   if(name == "flood") {
+      engine = ENGINE_FLOOD;
+   } else if(name == "astar") {
+      engine = ENGINE_ASTAR;
+   } else if(name == "bidirectional") {
+      engine = ENGINE_BIDIRECTIONAL;
+   } else if(name == "jps") {
+      engine = ENGINE_JPS;
+   } else if(name == "bitboard") {
+      engine = ENGINE_BITBOARD;
+   } else if(name == "parallel") {
+      engine = ENGINE_PARALLEL;
+   } else if(name == "hierarchical") {
+      engine = ENGINE_HIERARCHICAL;
+   } else {
+      throw std::runtime_error("Unknown engine '" + name + "'");
+   }
+
+   return engine;
+}
+
+ServedMaze load_maze(std::string filename) {
+   ServedMaze served;
+   served.mazeFile = NULL;
+   served.binaryFile = NULL;
+
+   // A binary maze file starts with its magic, anything else is read as text
+   char magic[sizeof(BINARY_MAZE_MAGIC)] = {0};
+   std::ifstream in(filename, std::ios::binary);
+   in.read(magic, sizeof(magic));
+   if(in.gcount() == sizeof(magic) && std::memcmp(magic, BINARY_MAZE_MAGIC, sizeof(magic)) == 0) {
+      served.binaryFile = new BinaryMazeFile(filename);
+      served.maze = served.binaryFile->getMaze();
+   } else {
+      served.mazeFile = new MazeFile(filename);
+      served.maze = served.mazeFile->getMaze();
+   }
+   served.planner = new PathPlanning(served.maze);
+
+   return served;
+}
+
+void serve(int inFd, int outFd, Server& server) {
+   bool open = true;
+   long lineNumber = 0;
+
+   // The bytes read after the last whole line, they are kept until the rest of the line comes
+   std::string pending;
+   std::string out;
+   std::vector<char> buffer(SERVER_READ_BYTES);
+
+   while(open) {
+      ssize_t bytesRead = read(inFd, buffer.data(), buffer.size());
+      if(bytesRead < 0 && errno == EINTR) {
+         continue;
+      }
+
+      // At the end of the input the last line does not need a line ending
+      if(bytesRead <= 0) {
+         pending.push_back('\n');
+         open = false;
+      } else {
+         pending.append(buffer.data(), bytesRead);
+      }
+
+      // More requests that are already waiting join the batch, a request that has to be waited for does not
+      pollfd waiting = {inFd, POLLIN, 0};
+      bool more = open && pending.size() < SERVER_BATCH_BYTES && poll(&waiting, 1, 0) > 0;
+
+      size_t lineEnd = pending.rfind('\n');
+      if(!more && lineEnd != std::string::npos) {
+         out.clear();
+         bool quit = serve_lines(pending.data(), lineEnd + 1, lineNumber, server, out);
+         pending.erase(0, lineEnd + 1);
+         if(!write_all(outFd, out) || quit) {
+            open = false;
+         }
+      }
+   }
+}
+
+bool serve_lines(const char* text, size_t length, long& lineNumber, Server& server, std::string& out) {
+   bool quit = false;
+   std::vector<Request> batch;
+
+   const char* end = text + length;
+   const char* line = text;
+   while(line < end && !quit) {
+      const char* lineEnd = std::find(line, end, '\n');
+      size_t lineLength = lineEnd - line;
+      if(lineLength > 0 && line[lineLength - 1] == '\r') {
+         lineLength--;
+      }
+      lineNumber++;
+
+      std::string command(line, std::min(lineLength, (size_t) 5));
+      if(lineLength == 0) {
+         // Nothing to answer
+      } else if((command == "stats" && lineLength == 5) || (command == "quit" && lineLength == 4)) {
+
+         // The queries before the command are answered first, so stats counts them
+         answer_batch(batch, server, out);
+         batch.clear();
+         if(command == "quit") {
+            quit = true;
+         } else {
+            out += "queries " + std::to_string(server.queries) +
+                   " seconds " + std::to_string(server.seconds) +
+                   " queries/sec " + std::to_string(server.seconds > 0 ? server.queries / server.seconds : 0.0) +
+                   "\n";
+         }
+      } else {
+         batch.push_back(Request());
+         parse_request(line, lineLength, lineNumber, server, batch.back());
+      }
+
+      line = lineEnd + 1;
+   }
+   answer_batch(batch, server, out);
+
+   return quit;
+}
+
+void parse_request(const char* text, size_t length, long lineNumber, Server& server, Request& request) {
+   request.maze = 0;
+   size_t at = 0;
+   while(at < length && at < SERVER_MAZE_DIGITS && text[at] >= '0' && text[at] <= '9') {
+      request.maze = request.maze * 10 + (text[at] - '0');
+      ++at;
+   }
+
+   // The positions after the maze are read the same way as a .initial file
+   int numPositions = 0;
+   int positions[2][2] = {{0, 0}, {0, 0}};
+   bool ok = at > 0 && at < length && text[at] == ' ';
+   if(ok) {
+      try {
+         PositionParser parser(text + at, length - at, POSITION_XY);
+         int x = 0;
+         int y = 0;
+         int distance = 0;
+         while(ok && parser.next(x, y, distance)) {
+            ok = numPositions < 2;
+            if(ok) {
+               positions[numPositions][0] = x;
+               positions[numPositions][1] = y;
+               numPositions++;
+            }
+         }
+      } catch (std::runtime_error& exception) {
+         ok = false;
+      }
+   }
+   request.startX = positions[0][0];
+   request.startY = positions[0][1];
+   request.goalX = positions[1][0];
+   request.goalY = positions[1][1];
+
+   if(!ok || numPositions != 2) {
+      request.error = "line " + std::to_string(lineNumber) + " is not <maze> (x,y) (x,y)";
+   } else if(request.maze >= (int) server.mazes.size()) {
+      request.error = "line " + std::to_string(lineNumber) + " has no maze " + std::to_string(request.maze);
+   } else {
+      Maze* maze = server.mazes[request.maze].maze;
+      bool inside = request.startX < maze->getCols() && request.startY < maze->getRows() &&
+                    request.goalX < maze->getCols() && request.goalY < maze->getRows();
+      if(!inside) {
+         request.error = "line " + std::to_string(lineNumber) + " has a position outside the maze";
+      }
+   }
+}
+
+void answer_batch(std::vector<Request>& batch, Server& server, std::string& out) {
+   auto start = std::chrono::steady_clock::now();
+
+   // Answer in order of maze and start, so each start is only flooded once
+   std::vector<int> order;
+   for(unsigned int i = 0; i < batch.size(); ++i) {
+      if(batch[i].error.empty()) {
+         order.push_back(i);
+      }
+   }
+   std::stable_sort(order.begin(), order.end(), [&batch](int a, int b) {
+      Request& first = batch[a];
+      Request& second = batch[b];
+      return first.maze != second.maze ? first.maze < second.maze :
+             first.startY != second.startY ? first.startY < second.startY : first.startX < second.startX;
+   });
+
+   std::vector<std::string> answers(batch.size());
+   for(int i : order) {
+      Request& request = batch[i];
+      PathPlanning* planner = server.mazes[request.maze].planner;
+      planner->initialPosition(request.startX, request.startY);
+      PDList* path = planner->getPath(request.goalX, request.goalY, server.engine);
+      append_path(path, answers[i]);
+      delete path;
+   }
+
+   // The answers go back in the order of the requests
+   for(unsigned int i = 0; i < batch.size(); ++i) {
+      if(!batch[i].error.empty()) {
+         out += "error " + batch[i].error;
+      } else {
+         out += answers[i];
+      }
+      out += '\n';
+   }
+
+   auto end = std::chrono::steady_clock::now();
+   server.queries += order.size();
+   server.seconds += std::chrono::duration<double>(end - start).count();
+}
+
+void append_path(PDList* path, std::string& out) {
+
+   // getPath lists the goal first, a .path file starts at the initial position
+   for(int i = path->size() - 1; i >= 0; --i) {
+      PDPtr position = path->get(i);
+      out += '(';
+      append_number(position->getX(), out);
+      out += ',';
+      append_number(position->getY(), out);
+      out += ',';
+      append_number(position->getDistance(), out);
+      out += ')';
+      if(i > 0) {
+         out += ' ';
+      }
+   }
+}
+
+void append_number(int number, std::string& out) {
+
+   // The digits come out last first, so they are put in a small buffer and added the right way around
+   char digits[12];
+   int numDigits = 0;
+   do {
+      digits[numDigits] = '0' + number % 10;
+      numDigits++;
+      number /= 10;
+   } while(number > 0);
+
+   while(numDigits > 0) {
+      numDigits--;
+      out += digits[numDigits];
+   }
+}
+
+bool write_all(int fd, std::string& text) {
+   size_t written = 0;
+
+   while(written < text.size()) {
+      ssize_t bytes = write(fd, text.data() + written, text.size() - written);
+      if(bytes < 0 && errno == EINTR) {
+         continue;
+      }
+      if(bytes <= 0) {
+         return false;
+      }
+      written += bytes;
+   }
+
+   return true;
+}
+
+void report(Server& server) {
+   std::cerr << "Answered " << server.queries << " queries in " << server.seconds * 1000 << " ms, "
+             << (server.seconds > 0 ? server.queries / server.seconds : 0.0) << " queries/sec" << std::endl;
+}
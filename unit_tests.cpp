@@ -1,14 +1,26 @@
 
+#include "BinaryMazeFile.h"
+#include "LandmarkIndex.h"
+#include "MazeFile.h"
 #include "PathPlanning.h"
+#include "PositionParser.h"
+#include "SharedPlanner.h"
+#include "TiledFlood.h"
 #include "Types.h"
 
 #include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <map>
-#include <regex>
+#include <sstream>
 #include <tuple>
 #include <string>
+#include <thread>
+#include <unistd.h>
 #include <vector>
 
 /*
@@ -19,24 +31,80 @@
  *    4. The goal position (optional)
  *    5. The path (optional)
  *
+ * The initial position file may hold more than one position. The test then
+ * checks the distance of every reachable position to the nearest of them,
+ * and that each position's owner really is that near (Milestone 2 only).
+ *
  * Full command
- *    ./unit_tests <testname>
+ *    ./unit_tests <testname> [engine]
  *
  * For example:
  *   ./unit_tests sampleTest/sample01
+ *   ./unit_tests sampleTest/sample01 astar
+ *
+ * The optional engine picks the search used for the Milestone 3 path
+ * (flood, astar, bidirectional, jps, bitboard, parallel or hierarchical, flood is the
+ * default), and the flood fill used for Milestone 2 (bitboard, parallel,
+ * or flood for every other engine). Engines other than flood may pick a different path when
+ * there is more than one shortest path, so their path is checked to be a
+ * valid shortest path instead. The hierarchical path may be longer than the shortest
+ * path, so it is only checked to be a valid path, using tiny clusters so even the
+ * sample mazes are split over many clusters.
+ *
+ * The engine "alt" is astar with a LandmarkIndex. The index is built, saved
+ * to a scratch file in $TMPDIR (or /tmp) and mapped back in before it is used.
+ *
+ * The engine "binary" writes the test to a binary maze file (see BinaryMazeFile.h)
+ * in $TMPDIR (or /tmp), maps it back in, and checks its starts, goal and distance
+ * field, then the reachable positions and path found on the mapped maze.
+ *
+ * With the flood engine, every cell of the maze is then closed (or opened)
+ * and put back one at a time with PathPlanning::setCell, and the repaired
+ * reachable positions and path are checked against a new PathPlanning.
+ *
+ * The engine "tiled" floods the maze file with TiledFlood, using tiny tiles
+ * so even the sample mazes are split over many tiles. It checks the
+ * reachable positions, and the distance of the goal for Milestone 3.
+ *
+ * The engine "limits" checks that files the planner cannot use safely are
+ * rejected when they are opened: a text maze too large for Maze's int
+ * indexes (a sparse scratch file in $TMPDIR or /tmp, so nothing is written
+ * but the first row), and binary maze files of the test that are changed to
+ * have an open border cell, a start outside the maze, or INT_MAX rows.
+ *
+ * The engine "shared" queries one SharedPlanner from several threads at once.
+ * Every thread has its own QueryContext (the first uses the context of its
+ * thread) and asks for the reachable positions and the path with the flood,
+ * astar, bidirectional and jps searches, with a query from another start in
+ * between. Each query goes to the next of more planners than a context keeps
+ * the state of, all on the same maze. The answers are checked against a
+ * PathPlanning after the threads end.
  *
  */
 
 #define ARGV_TEST    1
+#define ARGV_ENGINE  2
 #define EXT_MAZE     std::string(".maze")
 #define EXT_INT      std::string(".initial")
 #define EXT_POS      std::string(".pos")
 #define EXT_GOAL     std::string(".goal")
 #define EXT_PATH     std::string(".path")
 #define REQ_ARGS     1
+#define OPT_ARGS     1
 #define TUPLE_X      0
 #define TUPLE_Y      1
 #define TUPLE_DIST   2
+#define TILED_TEST_TILE      4
+#define TILED_TEST_RESIDENT  2
+#define HIERARCHICAL_TEST_CLUSTER 3
+#define LANDMARK_TEST_COUNT  3
+#define SHARED_TEST_THREADS  4
+// Where BinaryMazeFile's header keeps the rows, the bits offset and the starts offset
+#define BINARY_ROWS_AT           12
+#define BINARY_BITS_OFFSET_AT    32
+#define BINARY_STARTS_OFFSET_AT  40
+#define SHARED_TEST_ROUNDS   4
+#define SHARED_TEST_PLANNERS (QUERY_CONTEXT_PLANNERS + 1)
 
 #define DEBUG        1
 
@@ -47,23 +115,40 @@ typedef std::tuple<int,int,int> MyPosition;
 class Data {
 public:
    Data() :
-      maze(NULL),
+      mazeFile(NULL),
       rows(0),
       cols(0),
       initial(),
       goal(),
-      m3(false)
+      m3(false),
+      engine(ENGINE_FLOOD),
+      tiled(false),
+      landmarks(false),
+      binary(false),
+      limits(false),
+      shared(false)
    {};
 
-   Grid maze;
+   ~Data() {
+      delete mazeFile;
+   };
+
+   MazeFile* mazeFile;
    int rows;
    int cols;
    MyPosition initial;
+   std::vector<MyPosition> sources;
    MyPosition goal;
    std::vector<MyPosition> positions;
    std::vector<MyPosition> path;
 
    bool m3;
+   SearchEngine engine;
+   bool tiled;
+   bool landmarks;
+   bool binary;
+   bool limits;
+   bool shared;
 };
 typedef Data* DataPtr;
 
@@ -79,9 +164,24 @@ void load_data_initial(char** argv, DataPtr data);
 void load_data_pos(char** argv, DataPtr data);
 void load_data_goal(char** argv, DataPtr data);
 void load_data_path(char** argv, DataPtr data);
-void load_lines(std::ifstream& in, std::vector<std::string>& lines);
+SearchEngine parse_engine(int argc, char** argv);
+bool is_shortest_path(DataPtr data, PDList* path, int expectedSize);
 bool match_positions(MyPosition& posTest, PDPtr posrp);
+bool same_positions(PDList* a, PDList* b);
 bool run_unit_test(DataPtr data);
+bool run_sources_test(DataPtr data);
+bool run_tiled_test(DataPtr data, char** argv);
+LandmarkIndex* make_test_landmarks(DataPtr data);
+bool run_binary_test(DataPtr data);
+bool run_shared_test(DataPtr data);
+void run_shared_queries(std::vector<SharedPlanner*>* planners, QueryContext* context, DataPtr data,
+                        PDList* expectedReachable, PDList* expectedPath, int* failures);
+std::string make_scratch_file(std::string prefix);
+bool run_replanning_test(DataPtr data);
+bool run_limits_test(DataPtr data);
+bool is_rejected(std::string filename, bool binary, std::string expected);
+bool is_changed_rejected(std::string filename, long at, int32_t value, bool fromOffset);
+bool same_reachable(PathPlanning* repaired, PathPlanning* fresh, DataPtr data);
 
 int main(int argc, char** argv) {
 
@@ -92,12 +192,38 @@ int main(int argc, char** argv) {
       // Load file contents into data structure
       DataPtr data(new Data());
       load_data(argv, data);
+      data->tiled = argc > ARGV_ENGINE && std::string(argv[ARGV_ENGINE]) == "tiled";
+      data->landmarks = argc > ARGV_ENGINE && std::string(argv[ARGV_ENGINE]) == "alt";
+      data->binary = argc > ARGV_ENGINE && std::string(argv[ARGV_ENGINE]) == "binary";
+      data->shared = argc > ARGV_ENGINE && std::string(argv[ARGV_ENGINE]) == "shared";
+      data->limits = argc > ARGV_ENGINE && std::string(argv[ARGV_ENGINE]) == "limits";
+      if (!data->tiled && !data->binary && !data->shared && !data->limits) {
+         data->engine = parse_engine(argc, argv);
+      }
 
       // Run actual test
       if (DEBUG) {
          std::cout << "Running Unit Test" << std::endl;
       }
-      bool testPassed = run_unit_test(data);
+      // More than one initial position is a test of the nearest sources
+      // The tiled engine works on the maze file instead of a PathPlanning
+      bool testPassed = false;
+      if (data->sources.size() > 1) {
+         testPassed = run_sources_test(data);
+      } else if (data->tiled) {
+         testPassed = run_tiled_test(data, argv);
+      } else if (data->binary) {
+         testPassed = run_binary_test(data);
+      } else if (data->limits) {
+         testPassed = run_limits_test(data);
+      } else if (data->shared) {
+         testPassed = run_shared_test(data);
+      } else {
+         testPassed = run_unit_test(data);
+         if (testPassed && data->engine == ENGINE_FLOOD) {
+            testPassed = run_replanning_test(data);
+         }
+      }
       if (testPassed) {
          std::cout << "Test Passed" << std::endl;
       } else {
@@ -118,7 +244,7 @@ int main(int argc, char** argv) {
 }
 
 void check_args(int argc, char** argv) {
-   if (argc != REQ_ARGS + 1) {
+   if (argc < REQ_ARGS + 1 || argc > REQ_ARGS + OPT_ARGS + 1) {
       throw std::runtime_error("Not enough file names provided");
    }
 
@@ -147,6 +273,39 @@ void check_args(int argc, char** argv) {
    checkFile(posFilename);
 }
 
+SearchEngine parse_engine(int argc, char** argv) {
+   SearchEngine engine = ENGINE_FLOOD;
+
+   if (argc > ARGV_ENGINE) {
+      std::string name = argv[ARGV_ENGINE];
+      if (name == "flood") {
+         engine = ENGINE_FLOOD;
+      } else if (name == "astar") {
+         engine = ENGINE_ASTAR;
+      } else if (name == "bidirectional") {
+         engine = ENGINE_BIDIRECTIONAL;
+      } else if (name == "jps") {
+         engine = ENGINE_JPS;
+      } else if (name == "bitboard") {
+         engine = ENGINE_BITBOARD;
+      } else if (name == "parallel") {
+         engine = ENGINE_PARALLEL;
+      } else if (name == "hierarchical") {
+         engine = ENGINE_HIERARCHICAL;
+      } else if (name == "alt") {
+         engine = ENGINE_ASTAR;
+      } else {
+         throw std::runtime_error("Unknown engine '" + name + "'");
+      }
+
+      if (DEBUG) {
+         std::cout << "Search engine: " << name << std::endl;
+      }
+   }
+
+   return engine;
+}
+
 void load_data(char** argv, DataPtr data) {
    load_data_maze(argv, data);
    load_data_initial(argv, data);
@@ -167,39 +326,16 @@ void load_data(char** argv, DataPtr data) {
 void load_data_maze(char** argv, DataPtr data) {
    std::string filename = argv[ARGV_TEST] + EXT_MAZE;
 
-   std::ifstream in(filename);
-   std::vector<std::string> lines;
-   load_lines(in, lines);
-   if (lines.size() == 0) {
-      throw std::runtime_error("No Maze in file");
-   }
-
-   // Create data
-   int width = lines.front().size();
-   int height = lines.size();
-   data->maze = make_grid(height, width);
-
-   // Load Maze
-   for (unsigned int row = 0; row != lines.size(); ++row) {
-      std::string& line = lines[row];
-
-      // Check width
-      if (line.size() != (unsigned int) width) {
-         throw std::runtime_error("Maze dimensions not consistent");
-      }
-
-      // Load data
-      for (unsigned int col = 0; col != line.size(); ++col) {
-         data->maze[row][col] = (char) line[col];
-      }
-   }
-   data->rows = height;
-   data->cols = width;
+   // The maze is mapped straight from the file, PathPlanning plans on it without a copy
+   // MazeFile checks that every row is the same width
+   data->mazeFile = new MazeFile(filename);
+   data->rows = data->mazeFile->getRows();
+   data->cols = data->mazeFile->getCols();
    if (DEBUG) {
       std::cout << "Loaded Maze: " << std::endl;
       for (int row = 0; row != data->rows; ++row) {
          for (int col = 0; col != data->cols; ++col) {
-            std::cout << data->maze[row][col];
+            std::cout << data->mazeFile->getMaze()->getCell(col, row);
          }
          std::cout << std::endl;
       }
@@ -207,144 +343,77 @@ void load_data_maze(char** argv, DataPtr data) {
 }
 
 void load_data_initial(char** argv, DataPtr data) {
-   std::string filename = argv[ARGV_TEST] + EXT_INT;
-   std::ifstream in(filename);
-   std::vector<std::string> lines;
-   load_lines(in, lines);
-
-   // Load position
-   std::string line = lines[0];
-   std::regex regex("^[(]([0-9]+),([0-9]+)[)]$");
-   std::smatch match;
-   bool ok = std::regex_match(line, match, regex);
-
-   if (ok) {
-      MyPosition position;
-      std::get<TUPLE_X>(position) = std::stoi(match[1].str());
-      std::get<TUPLE_Y>(position) = std::stoi(match[2].str());
+   PositionParser parser(argv[ARGV_TEST] + EXT_INT, POSITION_XY);
+   MyPosition position;
 
-      data->initial = position;
+   // Load positions, the first one is the initial position
+   while (parser.next(std::get<TUPLE_X>(position), std::get<TUPLE_Y>(position),
+                      std::get<TUPLE_DIST>(position))) {
+      data->sources.push_back(position);
+   }
+   if (data->sources.empty()) {
+      throw std::runtime_error("No initial position in file");
+   }
+   data->initial = data->sources.front();
 
-      if (DEBUG) {
-         std::cout << "Loaded Initial Position: "
-                   << "("
-                   << std::get<TUPLE_X>(data->initial)
-                   << ","
-                   << std::get<TUPLE_Y>(data->initial)
-                   << ")"
-                   << std::endl;
-      }
-   } else {
-      throw std::runtime_error("Position format incorrect");
+   if (DEBUG) {
+      std::cout << "Loaded Initial Position: "
+                << "("
+                << std::get<TUPLE_X>(data->initial)
+                << ","
+                << std::get<TUPLE_Y>(data->initial)
+                << ")"
+                << std::endl;
    }
 }
 
 void load_data_pos(char** argv, DataPtr data) {
-   std::string filename = argv[ARGV_TEST] + EXT_POS;
-
-   std::ifstream in(filename);
-   std::vector<std::string> lines;
-   load_lines(in, lines);
-   if (DEBUG) {
-      std::cout << "Got: " << lines.size() << " positions" << std::endl;
-   }
+   PositionParser parser(argv[ARGV_TEST] + EXT_POS, POSITION_XYD);
+   MyPosition position;
 
    // Process each position
-   for (std::string& line : lines) {
-      std::regex regex("^[(]([0-9]+),([0-9]+),([0-9]+)[)]$");
-      std::smatch match;
-      bool ok = std::regex_match(line, match, regex);
-
-      if (ok) {
-         MyPosition position;
-         std::get<TUPLE_X>(position) = std::stoi(match[1].str());
-         std::get<TUPLE_Y>(position) = std::stoi(match[2].str());
-         std::get<TUPLE_DIST>(position) = std::stoi(match[3].str());
-
-         data->positions.push_back(position);
-      } else {
-         throw std::runtime_error("Position format incorrect");
-      }
+   while (parser.next(std::get<TUPLE_X>(position), std::get<TUPLE_Y>(position),
+                      std::get<TUPLE_DIST>(position))) {
+      data->positions.push_back(position);
+   }
+   if (DEBUG) {
+      std::cout << "Got: " << data->positions.size() << " positions" << std::endl;
    }
 }
 
 void load_data_goal(char** argv, DataPtr data) {
-   std::string filename = argv[ARGV_TEST] + EXT_GOAL;
-   std::ifstream in(filename);
-   std::vector<std::string> lines;
-   load_lines(in, lines);
+   PositionParser parser(argv[ARGV_TEST] + EXT_GOAL, POSITION_XY);
+   MyPosition position;
 
    // Load position
-   std::string line = lines[0];
-   std::regex regex("^[(]([0-9]+),([0-9]+)[)]$");
-   std::smatch match;
-   bool ok = std::regex_match(line, match, regex);
-
-   if (ok) {
-      MyPosition position;
-      std::get<TUPLE_X>(position) = std::stoi(match[1].str());
-      std::get<TUPLE_Y>(position) = std::stoi(match[2].str());
-
-      data->goal = position;
-
-      if (DEBUG) {
-         std::cout << "Loaded Initial Position: "
-                   << "("
-                   << std::get<TUPLE_X>(data->initial)
-                   << ","
-                   << std::get<TUPLE_Y>(data->initial)
-                   << ")"
-                   << std::endl;
-      }
-   } else {
-      throw std::runtime_error("Position format incorrect");
+   if (!parser.next(std::get<TUPLE_X>(position), std::get<TUPLE_Y>(position),
+                    std::get<TUPLE_DIST>(position))) {
+      throw std::runtime_error("No goal position in file");
    }
-}
-
-void load_data_path(char** argv, DataPtr data) {
-   std::string filename = argv[ARGV_TEST] + EXT_PATH;
+   data->goal = position;
 
-   std::ifstream in(filename);
-   std::vector<std::string> lines;
-   load_lines(in, lines);
    if (DEBUG) {
-      std::cout << "Got Path with: " << lines.size() << " positions" << std::endl;
-   }
-
-   // Process each position
-   for (std::string& line : lines) {
-      std::regex regex("^[(]([0-9]+),([0-9]+),([0-9]+)[)]$");
-      std::smatch match;
-      bool ok = std::regex_match(line, match, regex);
-
-      if (ok) {
-         MyPosition position;
-         std::get<TUPLE_X>(position) = std::stoi(match[1].str());
-         std::get<TUPLE_Y>(position) = std::stoi(match[2].str());
-         std::get<TUPLE_DIST>(position) = std::stoi(match[3].str());
-
-         data->path.push_back(position);
-      } else {
-         throw std::runtime_error("Position format incorrect");
-      }
+      std::cout << "Loaded Goal Position: "
+                << "("
+                << std::get<TUPLE_X>(data->goal)
+                << ","
+                << std::get<TUPLE_Y>(data->goal)
+                << ")"
+                << std::endl;
    }
 }
 
-void load_lines(std::ifstream& in, std::vector<std::string>& lines) {
-   while (!in.eof()) {
-      std::string line;
-      in >> line;
-
-      // Drop newline
-      if (line.back() == '\n') {
-         line.pop_back();
-      }
+void load_data_path(char** argv, DataPtr data) {
+   PositionParser parser(argv[ARGV_TEST] + EXT_PATH, POSITION_XYD);
+   MyPosition position;
 
-      // Add
-      lines.push_back(line);
+   // Process each position
+   while (parser.next(std::get<TUPLE_X>(position), std::get<TUPLE_Y>(position),
+                      std::get<TUPLE_DIST>(position))) {
+      data->path.push_back(position);
    }
-   if (lines.back().size() == 0) {
-      lines.pop_back();
+   if (DEBUG) {
+      std::cout << "Got Path with: " << data->path.size() << " positions" << std::endl;
    }
 }
 
@@ -358,6 +427,55 @@ bool match_positions(MyPosition& posTest, PDPtr posrp) {
    return match;
 }
 
+bool is_shortest_path(DataPtr data, PDList* path, int expectedSize) {
+   bool valid = path->size() == expectedSize && expectedSize > 0;
+
+   // The path goes from the goal back to the initial position
+   if (valid) {
+      PDPtr first = path->get(0);
+      PDPtr last = path->get(path->size() - 1);
+      valid = first->getX() == std::get<TUPLE_X>(data->goal)
+              && first->getY() == std::get<TUPLE_Y>(data->goal)
+              && last->getX() == std::get<TUPLE_X>(data->initial)
+              && last->getY() == std::get<TUPLE_Y>(data->initial)
+              && last->getDistance() == 0;
+   }
+
+   // Every step moves to a neighbour and is one closer to the initial position
+   for (int i = 1; valid && i != path->size(); ++i) {
+      PDPtr from = path->get(i - 1);
+      PDPtr to = path->get(i);
+      valid = std::abs(from->getX() - to->getX())
+              + std::abs(from->getY() - to->getY()) == 1
+              && from->getDistance() == to->getDistance() + 1;
+   }
+
+   // Every position except the initial one is reachable with that distance
+   for (int i = 0; valid && i != path->size() - 1; ++i) {
+      bool found = false;
+      for (MyPosition& posTest : data->positions) {
+         if (match_positions(posTest, path->get(i))) {
+            found = true;
+         }
+      }
+      valid = found;
+   }
+
+   return valid;
+}
+
+bool same_positions(PDList* a, PDList* b) {
+   bool same = a->size() == b->size();
+
+   for (int i = 0; same && i != a->size(); ++i) {
+      same = a->get(i)->getX() == b->get(i)->getX()
+             && a->get(i)->getY() == b->get(i)->getY()
+             && a->get(i)->getDistance() == b->get(i)->getDistance();
+   }
+
+   return same;
+}
+
 bool run_unit_test(DataPtr data) {
    bool testPassed = false;
 
@@ -366,14 +484,23 @@ bool run_unit_test(DataPtr data) {
       std::cout << "Create Position filter" << std::endl;
    }
    PathPlanning* rp =
-      new PathPlanning(data->maze, data->rows, data->cols);
+      new PathPlanning(data->mazeFile->getMaze());
+   rp->setClusterSize(HIERARCHICAL_TEST_CLUSTER);
+
+   // The landmarks are only used by astar
+   LandmarkIndex* landmarks = NULL;
+   bool landmarksMatch = true;
+   if (data->landmarks) {
+      landmarks = make_test_landmarks(data);
+      landmarksMatch = rp->setLandmarks(landmarks);
+   }
 
    // Set Initial Position
    rp->initialPosition(std::get<TUPLE_X>(data->initial),
                        std::get<TUPLE_Y>(data->initial));
 
    // Get final positions
-   PDList* finalPositions = rp->getReachablePositions();
+   PDList* finalPositions = rp->getReachablePositions(data->engine);
    int numPositions = finalPositions->size();
    if (numPositions > 0) {
       if (DEBUG) {
@@ -417,6 +544,15 @@ bool run_unit_test(DataPtr data) {
       std::cout << "Testing Milestone 3" << std::endl;
       PDList* path = rp->getPath(std::get<TUPLE_X>(data->goal),
                                  std::get<TUPLE_Y>(data->goal));
+
+      // Other engines are checked against the length of the flood path
+      PDList* floodPath = NULL;
+      if (data->engine != ENGINE_FLOOD) {
+         floodPath = path;
+         path = rp->getPath(std::get<TUPLE_X>(data->goal),
+                            std::get<TUPLE_Y>(data->goal),
+                            data->engine);
+      }
       numPositions = path->size();
       if (DEBUG) {
          std::cout << "Path:" << std::endl;
@@ -431,7 +567,20 @@ bool run_unit_test(DataPtr data) {
       }
 
       // Test all Positions are expected
-      if ((unsigned int) numPositions == data->path.size()) {
+      if (floodPath != NULL) {
+         // A hierarchical path may be longer, but must still be a valid path
+         int expectedSize = floodPath->size();
+         if (data->engine == ENGINE_HIERARCHICAL && path->size() > expectedSize) {
+            if (DEBUG) {
+               std::cout << "Path is " << path->size() - expectedSize
+                         << " longer than the shortest path" << std::endl;
+            }
+            expectedSize = path->size();
+         }
+         testPassed = testPassed
+                      && is_shortest_path(data, path, expectedSize);
+         delete floodPath;
+      } else if ((unsigned int) numPositions == data->path.size()) {
          std::map<int,bool> checked;
          for(MyPosition& posTest : data->path) {
             for (int i = 0; i != numPositions; ++i) {
@@ -444,15 +593,633 @@ bool run_unit_test(DataPtr data) {
         // If not enough true items in the map, test failed
         testPassed = checked.size() == data->path.size();
       }
+
+      // The batch query must give the same path as getPath, reusing the same distance field
+      if (data->engine == ENGINE_FLOOD) {
+         PDList* goals = new PDList();
+         goals->addBack(new PositionDistance(std::get<TUPLE_X>(data->goal),
+                                             std::get<TUPLE_Y>(data->goal)));
+         std::vector<PDList*> paths = rp->getPaths(goals);
+         if (paths.size() != 1 || !same_positions(paths[0], path)) {
+            if (DEBUG) {
+               std::cout << "getPaths did not match getPath" << std::endl;
+            }
+            testPassed = false;
+         }
+         for (PDList* batchPath : paths) {
+            delete batchPath;
+         }
+         delete goals;
+      }
        delete path;
    }
 
+   // A path from a cell to itself is just that cell with every engine, even on a closed cell
+   bool found = false;
+   for (int y = 0; !found && y != data->rows; ++y) {
+      for (int x = 0; !found && x != data->cols; ++x) {
+         found = data->mazeFile->getMaze()->getCell(x, y) != MAZE_OPEN;
+         if (found) {
+            rp->initialPosition(x, y);
+            PDList* selfPath = rp->getPath(x, y, data->engine);
+            testPassed = testPassed && selfPath->size() == 1
+                         && selfPath->get(0)->getX() == x && selfPath->get(0)->getY() == y
+                         && selfPath->get(0)->getDistance() == 0;
+            delete selfPath;
+         }
+      }
+   }
+
    // Delete Path Planner
    delete rp;
+   delete landmarks;
   
+   return testPassed && landmarksMatch;
+}
+
+std::string make_scratch_file(std::string prefix) {
+   const char* scratch = std::getenv("TMPDIR");
+   std::string filename = std::string(scratch != NULL ? scratch : "/tmp") + "/" + prefix + "XXXXXX";
+   int fd = mkstemp(&filename[0]);
+   if (fd < 0) {
+      throw std::runtime_error("Could not make a scratch file '" + filename + "'");
+   }
+   close(fd);
+
+   return filename;
+}
+
+LandmarkIndex* make_test_landmarks(DataPtr data) {
+   std::string filename = make_scratch_file("landmarks");
+
+   // The mapped index stays readable after the file is removed
+   LandmarkIndex* built = new LandmarkIndex(data->mazeFile->getMaze(), LANDMARK_TEST_COUNT);
+   built->save(filename);
+   delete built;
+   LandmarkIndex* landmarks = new LandmarkIndex(filename);
+   unlink(filename.c_str());
+
+   if (DEBUG) {
+      std::cout << "Landmarks:";
+      for (int i = 0; i != landmarks->getNumLandmarks(); ++i) {
+         std::cout << " (" << landmarks->getLandmarkX(i) << ","
+                   << landmarks->getLandmarkY(i) << ")";
+      }
+      std::cout << std::endl;
+   }
+
+   return landmarks;
+}
+
+bool run_sources_test(DataPtr data) {
+   bool testPassed = false;
+
+   PathPlanning* rp =
+      new PathPlanning(data->mazeFile->getMaze());
+
+   PDList* sources = new PDList();
+   for (MyPosition& source : data->sources) {
+      sources->addBack(new PositionDistance(std::get<TUPLE_X>(source),
+                                            std::get<TUPLE_Y>(source)));
+   }
+
+   std::vector<int> owners;
+   PDList* nearest = rp->getNearestSources(sources, owners);
+   int numPositions = nearest->size();
+   if (DEBUG) {
+      std::cout << "Nearest Sources:" << std::endl;
+      for (int i = 0; i != numPositions; ++i) {
+         std::cout << "("
+                   << nearest->get(i)->getX()
+                   << ","
+                   << nearest->get(i)->getY()
+                   << ","
+                   << nearest->get(i)->getDistance()
+                   << ") from "
+                   << owners[i]
+                   << std::endl;
+      }
+   }
+
+   // Test all Positions are expected
+   if ((unsigned int) numPositions == data->positions.size()
+       && owners.size() == data->positions.size()) {
+      std::map<int,bool> checked;
+      for (MyPosition& posTest : data->positions) {
+         for (int i = 0; i != numPositions; ++i) {
+            if (match_positions(posTest, nearest->get(i))) {
+               checked[i] = true;
+            }
+         }
+      }
+      testPassed = checked.size() == data->positions.size();
+   }
+
+   // Every owner must be a source at the nearest distance, flood from each source on its own to check
+   for (unsigned int source = 0; testPassed && source != data->sources.size(); ++source) {
+      rp->initialPosition(std::get<TUPLE_X>(data->sources[source]),
+                          std::get<TUPLE_Y>(data->sources[source]));
+      PDList* reachable = rp->getReachablePositions();
+
+      for (int i = 0; testPassed && i != numPositions; ++i) {
+         if (owners[i] == (int) source) {
+            bool found = false;
+            for (int j = 0; j != reachable->size(); ++j) {
+               if (reachable->get(j)->getX() == nearest->get(i)->getX()
+                   && reachable->get(j)->getY() == nearest->get(i)->getY()
+                   && reachable->get(j)->getDistance() == nearest->get(i)->getDistance()) {
+                  found = true;
+               }
+            }
+            testPassed = found;
+         }
+      }
+      delete reachable;
+   }
+
+   delete nearest;
+   delete sources;
+   delete rp;
+
+   return testPassed;
+}
+
+bool run_tiled_test(DataPtr data, char** argv) {
+   bool testPassed = false;
+
+   const char* scratch = std::getenv("TMPDIR");
+   TiledFlood* tiled = new TiledFlood(argv[ARGV_TEST] + EXT_MAZE,
+                                      scratch != NULL ? scratch : "/tmp",
+                                      TILED_TEST_TILE, TILED_TEST_RESIDENT);
+   tiled->flood(std::get<TUPLE_X>(data->initial), std::get<TUPLE_Y>(data->initial));
+
+   // The positions are written in the .pos format, so read them back the same way
+   std::stringstream out;
+   tiled->writePositions(out);
+   std::string text = out.str();
+   PositionParser parser(text.data(), text.size(), POSITION_XYD);
+   std::vector<MyPosition> positions;
+   MyPosition position;
+   while (parser.next(std::get<TUPLE_X>(position), std::get<TUPLE_Y>(position),
+                      std::get<TUPLE_DIST>(position))) {
+      positions.push_back(position);
+   }
+
+   // Test all Positions are expected
+   if (positions.size() == data->positions.size()) {
+      std::sort(positions.begin(), positions.end());
+      std::vector<MyPosition> expected = data->positions;
+      std::sort(expected.begin(), expected.end());
+      testPassed = positions == expected;
+   }
+
+   // Milestone 3: the distance of the goal must be its distance in the reachable positions
+   if (data->m3) {
+      std::cout << "Testing Milestone 3" << std::endl;
+      int distance = tiled->getDistance(std::get<TUPLE_X>(data->goal),
+                                        std::get<TUPLE_Y>(data->goal));
+      bool found = false;
+      for (MyPosition& posTest : data->positions) {
+         if (std::get<TUPLE_X>(posTest) == std::get<TUPLE_X>(data->goal)
+             && std::get<TUPLE_Y>(posTest) == std::get<TUPLE_Y>(data->goal)) {
+            found = std::get<TUPLE_DIST>(posTest) == distance;
+         }
+      }
+      testPassed = testPassed && found;
+   }
+
+   if (DEBUG) {
+      TiledStats stats = tiled->getStats();
+      std::cout << "Tiles: " << stats.tileLoads << " loads, "
+                << stats.tileEvictions << " evictions, "
+                << stats.tilePasses << " passes, "
+                << stats.bytesRead << " bytes read, "
+                << stats.bytesWritten << " bytes written, "
+                << stats.peakResidentBytes << " bytes in memory"
+                << std::endl;
+   }
+
+   delete tiled;
+
+   return testPassed;
+}
+
+bool run_binary_test(DataPtr data) {
+   bool testPassed = true;
+
+   // Write the test with the distance field of the text maze
+   PDList* starts = new PDList();
+   for (MyPosition& source : data->sources) {
+      starts->addBack(std::get<TUPLE_X>(source), std::get<TUPLE_Y>(source), 0);
+   }
+   PDList* goals = new PDList();
+   if (data->m3) {
+      goals->addBack(std::get<TUPLE_X>(data->goal), std::get<TUPLE_Y>(data->goal), 0);
+   }
+   PathPlanning* textPlanner = new PathPlanning(data->mazeFile->getMaze());
+   textPlanner->initialPosition(std::get<TUPLE_X>(data->initial), std::get<TUPLE_Y>(data->initial));
+   PDList* reachable = textPlanner->getReachablePositions();
+
+   // Some .path files list every reachable position, so the path is checked against the text maze's path
+   int pathSize = 0;
+   if (data->m3) {
+      PDList* textPath = textPlanner->getPath(std::get<TUPLE_X>(data->goal),
+                                              std::get<TUPLE_Y>(data->goal));
+      pathSize = textPath->size();
+      delete textPath;
+   }
+
+   std::string filename = make_scratch_file("maze");
+   BinaryMazeFile::write(filename, data->mazeFile->getMaze(), starts, goals, reachable);
+   BinaryMazeFile* binary = new BinaryMazeFile(filename);
+   unlink(filename.c_str());
+   delete reachable;
+   delete textPlanner;
+   delete goals;
+   delete starts;
+
+   // The header and positions must be the ones written
+   testPassed = binary->getRows() == data->rows && binary->getCols() == data->cols
+                && binary->getNumStarts() == (int) data->sources.size()
+                && binary->getNumGoals() == (data->m3 ? 1 : 0)
+                && binary->hasDistances();
+   for (int i = 0; testPassed && i != binary->getNumStarts(); ++i) {
+      testPassed = binary->getStartX(i) == std::get<TUPLE_X>(data->sources[i])
+                   && binary->getStartY(i) == std::get<TUPLE_Y>(data->sources[i]);
+   }
+   if (testPassed && data->m3) {
+      testPassed = binary->getGoalX(0) == std::get<TUPLE_X>(data->goal)
+                   && binary->getGoalY(0) == std::get<TUPLE_Y>(data->goal);
+   }
+
+   // The distance field must hold exactly the expected positions, and the start
+   int numReached = 0;
+   for (int y = 0; testPassed && y != data->rows; ++y) {
+      for (int x = 0; x != data->cols; ++x) {
+         if (binary->getDistance(x, y) > 0) {
+            numReached++;
+         }
+      }
+   }
+   for (MyPosition& posTest : data->positions) {
+      testPassed = testPassed && binary->getDistance(std::get<TUPLE_X>(posTest),
+                                                     std::get<TUPLE_Y>(posTest))
+                                 == std::get<TUPLE_DIST>(posTest);
+   }
+   testPassed = testPassed && numReached == (int) data->positions.size();
+   if (DEBUG) {
+      std::cout << "Binary file header, positions and distances "
+                << (testPassed ? "match" : "do not match") << std::endl;
+   }
+
+   // Plan on the packed maze where it is mapped
+   PathPlanning* rp = new PathPlanning(binary->getMaze());
+   rp->initialPosition(binary->getStartX(0), binary->getStartY(0));
+   PDList* finalPositions = rp->getReachablePositions();
+   std::vector<MyPosition> positions;
+   for (int i = 0; i != finalPositions->size(); ++i) {
+      PDPtr position = finalPositions->get(i);
+      positions.push_back(MyPosition(position->getX(), position->getY(), position->getDistance()));
+   }
+   std::sort(positions.begin(), positions.end());
+   std::vector<MyPosition> expected = data->positions;
+   std::sort(expected.begin(), expected.end());
+   testPassed = testPassed && positions == expected;
+   delete finalPositions;
+
+   if (data->m3) {
+      std::cout << "Testing Milestone 3" << std::endl;
+      PDList* path = rp->getPath(binary->getGoalX(0), binary->getGoalY(0));
+      testPassed = testPassed && is_shortest_path(data, path, pathSize);
+      delete path;
+   }
+
+   delete rp;
+   delete binary;
+
+   return testPassed;
+}
+
+bool run_limits_test(DataPtr data) {
+   bool testPassed = true;
+
+   // The first row of the test, then sparse zeros up to just enough rows to be too large
+   std::string filename = make_scratch_file("toolarge");
+   std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+   for (int x = 0; x != data->cols; ++x) {
+      out << data->mazeFile->getMaze()->getCell(x, 0);
+   }
+   out << '\n';
+   out.close();
+   long stride = data->cols + 1;
+   long rows = INT_MAX / stride;
+   if (truncate(filename.c_str(), rows * stride - 1) == 0) {
+      testPassed = is_rejected(filename, false, "Maze too large");
+   } else {
+      testPassed = false;
+   }
+   unlink(filename.c_str());
+
+   // The binary maze file of the test is read back, then changed one number at a time
+   std::string binaryFile = make_scratch_file("limits");
+   PDList* starts = new PDList();
+   starts->addBack(std::get<TUPLE_X>(data->initial), std::get<TUPLE_Y>(data->initial), 0);
+   PDList* goals = new PDList();
+   BinaryMazeFile::write(binaryFile, data->mazeFile->getMaze(), starts, goals, NULL);
+   delete starts;
+   delete goals;
+   delete new BinaryMazeFile(binaryFile);
+
+   // The first bit of the packed maze is the top left corner of the border
+   testPassed = testPassed && is_changed_rejected(binaryFile, BINARY_BITS_OFFSET_AT, 1, true)
+                && is_changed_rejected(binaryFile, BINARY_STARTS_OFFSET_AT, data->cols, true)
+                && is_changed_rejected(binaryFile, BINARY_STARTS_OFFSET_AT, -1, true)
+                && is_changed_rejected(binaryFile, BINARY_ROWS_AT, INT_MAX, false);
+   unlink(binaryFile.c_str());
+
+   return testPassed;
+}
+
+bool is_changed_rejected(std::string filename, long at, int32_t value, bool fromOffset) {
+   std::string changedFile = make_scratch_file("changed");
+   std::ifstream in(filename, std::ios::binary);
+   std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+   in.close();
+
+   // The value goes at the given place in the header, or at the offset stored there
+   if (fromOffset) {
+      uint64_t offset = 0;
+      std::memcpy(&offset, &bytes[at], sizeof(offset));
+      at = offset;
+   }
+   std::memcpy(&bytes[at], &value, sizeof(value));
+
+   std::ofstream out(changedFile, std::ios::binary | std::ios::trunc);
+   out.write(bytes.data(), bytes.size());
+   out.close();
+   bool rejected = is_rejected(changedFile, true, "Not a binary maze file");
+   unlink(changedFile.c_str());
+
+   return rejected;
+}
+
+bool is_rejected(std::string filename, bool binary, std::string expected) {
+   bool rejected = false;
+
+   try {
+      if (binary) {
+         delete new BinaryMazeFile(filename);
+      } else {
+         delete new MazeFile(filename);
+      }
+   } catch (std::runtime_error& exception) {
+      rejected = std::string(exception.what()).find(expected) != std::string::npos;
+      if (DEBUG) {
+         std::cout << "Rejected: " << exception.what() << std::endl;
+      }
+   }
+
+   return rejected;
+}
+
+bool run_shared_test(DataPtr data) {
+
+   // The expected answers come from a PathPlanning on the same maze
+   PathPlanning* rp = new PathPlanning(data->mazeFile->getMaze());
+   rp->initialPosition(std::get<TUPLE_X>(data->initial), std::get<TUPLE_Y>(data->initial));
+   PDList* expectedReachable = rp->getReachablePositions();
+   PDList* expectedPath = NULL;
+   if (data->m3) {
+      std::cout << "Testing Milestone 3" << std::endl;
+      expectedPath = rp->getPath(std::get<TUPLE_X>(data->goal), std::get<TUPLE_Y>(data->goal));
+   }
+
+   // Every thread counts its own failures, they are only read once the threads have ended
+   std::vector<SharedPlanner*> planners;
+   for (int p = 0; p != SHARED_TEST_PLANNERS; ++p) {
+      planners.push_back(new SharedPlanner(data->mazeFile->getMaze()));
+   }
+   std::vector<QueryContext*> contexts(SHARED_TEST_THREADS, NULL);
+   std::vector<int> failures(SHARED_TEST_THREADS, 0);
+   std::vector<std::thread> threads;
+   for (int t = 0; t != SHARED_TEST_THREADS; ++t) {
+      if (t != 0) {
+         contexts[t] = new QueryContext();
+      }
+      threads.push_back(std::thread(run_shared_queries, &planners, contexts[t], data,
+                                    expectedReachable, expectedPath, &failures[t]));
+   }
+
+   bool testPassed = true;
+   for (int t = 0; t != SHARED_TEST_THREADS; ++t) {
+      threads[t].join();
+      if (DEBUG) {
+         std::cout << "Thread " << t << ": " << failures[t] << " failed queries" << std::endl;
+      }
+      testPassed = testPassed && failures[t] == 0;
+      delete contexts[t];
+   }
+
+   for (SharedPlanner* planner : planners) {
+      delete planner;
+   }
+
+   // A context can still be used once the planner it was set up for is gone
+   SharedPlanner* planner = new SharedPlanner(data->mazeFile->getMaze());
+   QueryContext* context = new QueryContext();
+   PDList* reachable = planner->getReachablePositions(context, std::get<TUPLE_X>(data->initial),
+                                                      std::get<TUPLE_Y>(data->initial));
+   delete planner;
+   planner = new SharedPlanner(data->mazeFile->getMaze());
+   PDList* again = planner->getReachablePositions(context, std::get<TUPLE_X>(data->initial),
+                                                  std::get<TUPLE_Y>(data->initial));
+   testPassed = testPassed && same_positions(reachable, again)
+                && same_positions(reachable, expectedReachable);
+
+   // Clearing a context frees what it holds, and it can still be used afterwards
+   context->clear();
+   testPassed = testPassed && context->bytes() == 0;
+   delete again;
+   again = planner->getReachablePositions(context, std::get<TUPLE_X>(data->initial),
+                                          std::get<TUPLE_Y>(data->initial));
+   testPassed = testPassed && same_positions(reachable, again) && context->bytes() > 0;
+
+   // Deleting a planner frees its state in the context of the thread that deletes it
+   QueryContext* threadContext = SharedPlanner::getThreadContext();
+   threadContext->clear();
+   delete again;
+   again = planner->getReachablePositions(std::get<TUPLE_X>(data->initial),
+                                          std::get<TUPLE_Y>(data->initial));
+   testPassed = testPassed && same_positions(reachable, again) && threadContext->bytes() > 0;
+   delete planner;
+   planner = NULL;
+   testPassed = testPassed && threadContext->bytes() == 0;
+
+   // A negative size is an empty maze, the same as PathPlanning
+   SharedPlanner* empty = new SharedPlanner(NULL, -1, -1);
+   PDList* none = empty->getReachablePositions(context, 0, 0);
+   testPassed = testPassed && none->size() == 0;
+   delete none;
+   delete empty;
+
+   delete reachable;
+   delete again;
+   delete context;
+   delete expectedReachable;
+   delete expectedPath;
+   delete rp;
+
    return testPassed;
 }
 
+void run_shared_queries(std::vector<SharedPlanner*>* planners, QueryContext* context, DataPtr data,
+                        PDList* expectedReachable, PDList* expectedPath, int* failures) {
+   const SearchEngine engines[] = {ENGINE_FLOOD, ENGINE_ASTAR, ENGINE_BIDIRECTIONAL, ENGINE_JPS};
+   int x = std::get<TUPLE_X>(data->initial);
+   int y = std::get<TUPLE_Y>(data->initial);
+   int next = 0;
+
+   for (int round = 0; round != SHARED_TEST_ROUNDS; ++round) {
+      for (SearchEngine engine : engines) {
+         // Even rounds move between two planners, which the context keeps the state of,
+         // odd rounds between more planners than it keeps
+         int p = round % 2 == 0 ? next % 2 : next % planners->size();
+         SharedPlanner* planner = (*planners)[p];
+         next++;
+
+         // The reachable positions must be in the same order as PathPlanning's
+         PDList* reachable = context != NULL ? planner->getReachablePositions(context, x, y)
+                                             : planner->getReachablePositions(x, y);
+         if (!same_positions(reachable, expectedReachable)) {
+            (*failures)++;
+         }
+
+         // Flood from another start, so the next query cannot use the last flood fill
+         if (reachable->size() > 0) {
+            PDPtr other = reachable->get(round % reachable->size());
+            PDList* otherReachable = context != NULL
+               ? planner->getReachablePositions(context, other->getX(), other->getY())
+               : planner->getReachablePositions(other->getX(), other->getY());
+            if (otherReachable->size() != expectedReachable->size()) {
+               (*failures)++;
+            }
+            delete otherReachable;
+         }
+         delete reachable;
+
+         // The flood path must be PathPlanning's path, the others any shortest path
+         if (expectedPath != NULL) {
+            int goalX = std::get<TUPLE_X>(data->goal);
+            int goalY = std::get<TUPLE_Y>(data->goal);
+            PDList* path = context != NULL ? planner->getPath(context, x, y, goalX, goalY, engine)
+                                           : planner->getPath(x, y, goalX, goalY, engine);
+            bool valid = engine == ENGINE_FLOOD ? same_positions(path, expectedPath)
+                                                : is_shortest_path(data, path, expectedPath->size());
+            if (!valid) {
+               (*failures)++;
+            }
+            delete path;
+         }
+      }
+   }
+}
+
+bool run_replanning_test(DataPtr data) {
+   bool testPassed = true;
+
+   if (DEBUG) {
+      std::cout << "Testing setCell" << std::endl;
+   }
+   Maze* maze = data->mazeFile->getMaze();
+   PathPlanning* rp = new PathPlanning(maze);
+   rp->initialPosition(std::get<TUPLE_X>(data->initial),
+                       std::get<TUPLE_Y>(data->initial));
+   delete rp->getReachablePositions();
+
+   // Close every open cell and open every other cell, then put it back, checking after each change
+   for (int y = 0; testPassed && y != data->rows; ++y) {
+      for (int x = 0; testPassed && x != data->cols; ++x) {
+         char original = maze->getCell(x, y);
+         char changes[] = {original == '.' ? '=' : '.', original};
+
+         for (char change : changes) {
+            rp->setCell(x, y, change);
+
+            // A new planner gets its own copy of the changed maze
+            Grid grid = make_grid(data->rows, data->cols);
+            for (int row = 0; row != data->rows; ++row) {
+               for (int col = 0; col != data->cols; ++col) {
+                  grid[row][col] = maze->getCell(col, row);
+               }
+            }
+            PathPlanning* fresh = new PathPlanning(grid, data->rows, data->cols);
+            fresh->initialPosition(std::get<TUPLE_X>(data->initial),
+                                   std::get<TUPLE_Y>(data->initial));
+
+            if (testPassed && !same_reachable(rp, fresh, data)) {
+               if (DEBUG) {
+                  std::cout << "setCell(" << x << "," << y << "," << change
+                            << ") did not match a new PathPlanning" << std::endl;
+               }
+               testPassed = false;
+            }
+            delete fresh;
+         }
+      }
+   }
+
+   delete rp;
+
+   return testPassed;
+}
+
+bool same_reachable(PathPlanning* repaired, PathPlanning* fresh, DataPtr data) {
+   PDList* a = repaired->getReachablePositions();
+   PDList* b = fresh->getReachablePositions();
+
+   // The positions with the same distance may be in a different order
+   std::vector<MyPosition> positionsA;
+   std::vector<MyPosition> positionsB;
+   for (int i = 0; i != a->size(); ++i) {
+      positionsA.push_back(MyPosition(a->get(i)->getX(), a->get(i)->getY(),
+                                      a->get(i)->getDistance()));
+   }
+   for (int i = 0; i != b->size(); ++i) {
+      positionsB.push_back(MyPosition(b->get(i)->getX(), b->get(i)->getY(),
+                                      b->get(i)->getDistance()));
+   }
+   std::sort(positionsA.begin(), positionsA.end());
+   std::sort(positionsB.begin(), positionsB.end());
+   bool same = positionsA == positionsB;
+   delete a;
+   delete b;
+
+   // The repaired path may be a different shortest path, so check its steps
+   if (same && data->m3) {
+      PDList* path = repaired->getPath(std::get<TUPLE_X>(data->goal),
+                                       std::get<TUPLE_Y>(data->goal));
+      PDList* freshPath = fresh->getPath(std::get<TUPLE_X>(data->goal),
+                                         std::get<TUPLE_Y>(data->goal));
+      same = path->size() == freshPath->size();
+      for (int i = 1; same && i < path->size(); ++i) {
+         same = std::abs(path->get(i - 1)->getX() - path->get(i)->getX())
+                + std::abs(path->get(i - 1)->getY() - path->get(i)->getY()) == 1
+                && path->get(i - 1)->getDistance() == path->get(i)->getDistance() + 1;
+      }
+
+      // Every step except the initial position must be reachable with that distance
+      for (int i = 0; same && i < path->size() - 1; ++i) {
+         same = std::binary_search(positionsB.begin(), positionsB.end(),
+                                   MyPosition(path->get(i)->getX(), path->get(i)->getY(),
+                                              path->get(i)->getDistance()));
+      }
+      delete path;
+      delete freshPath;
+   }
+
+   return same;
+}
+
 Grid make_grid(const int rows, const int cols) {
    Grid grid = NULL;
 